@@ -1,18 +1,19 @@
 
 #include <common/time.hpp>
 #include <common/task.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
 
-std::vector<int> parseInstructions(std::istream&& input) {
-  std::vector<int> instructions;
+namespace day01 {
 
-  while (input) {
-    char direction;
-    int distance;
-    input >> direction >> distance;
+std::vector<int> parseInstructions(std::string_view input) {
+  std::vector<int> instructions;
 
-    if (input) { // read successful
-      instructions.push_back(direction == 'R' ? distance : -distance);
-    }
+  input::Scanner scanner(input);
+  for (scanner.skipWhitespace(); !scanner.empty(); scanner.skipWhitespace()) {
+    char direction = scanner.next();
+    int distance = scanner.integer<int>();
+    instructions.push_back(direction == 'R' ? distance : -distance);
   }
 
   return instructions;
@@ -20,10 +21,9 @@ std::vector<int> parseInstructions(std::istream&& input) {
 
 const int DIAL_SIZE = 100;
 
-int main() {
-  common::Time t;
-
-  auto instructions = parseInstructions(task::input());
+registry::Result solve(std::string_view input) {
+  auto instructions = parseInstructions(input);
+  registry::parsed();
 
   int part1 = 0;
   int part2 = 0;
@@ -56,8 +56,10 @@ int main() {
   }
   
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  return { part1, part2 };
+}
+
 }
 
+REGISTER_SOLVER(1, day01::solve);
+SOLVER_MAIN(day01::solve)
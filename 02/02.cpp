@@ -1,11 +1,15 @@
 
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/regex.hpp>
 #include <common/math.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/thread_pool.hpp>
 
 #include <set>
 
+namespace day02 {
+
 /** Repeat a prefix multiple times be repeated multiplication and addition 12 -> 12*10+12 = 1212 -> ...
  */
 int64_t repeatNumber(int64_t prefix, int64_t factor, int times) {
@@ -80,32 +84,39 @@ struct Range {
 
 
 
-  static std::vector<Range> parseRanges(std::string input) {
+  /** Parses the comma separated list of "begin-end" ranges */
+  static std::vector<Range> parseRanges(std::string_view input) {
     std::vector<Range> ranges;
-    std::regex rangeRegex("([0-9]+)-([0-9]+)");
-    for (auto match : regex::iter(input, rangeRegex)) {
-      ranges.push_back(Range { .begin = std::stoll(match[1].str()), .end = std::stoll(match[2].str()) + 1 });
+    input::Scanner scanner(input);
+    for (scanner.skipWhitespace(); !scanner.empty(); scanner.skipWhitespace()) {
+      auto begin = scanner.integer<int64_t>();
+      scanner.skip('-');
+      auto end = scanner.integer<int64_t>();
+      ranges.push_back(Range { .begin = begin, .end = end + 1 });
+      scanner.skip(',');
     }
     return ranges;
   }
 };
 
 
-int main() {
-  common::Time t;
-
-  auto ranges = Range::parseRanges(task::inputString());
+registry::Result solve(std::string_view input) {
+  auto ranges = Range::parseRanges(input);
+  registry::parsed();
 
 
-  int64_t part1 = 0;
-  int64_t part2 = 0;
+  // OPTIMIZATION: The ranges are independent of each other, so their sums are calculated in parallel
+  using Sums = std::pair<int64_t, int64_t>;
+  auto [part1, part2] = threads::parallelReduce(0, ranges.size(), Sums(), [&](size_t i) {
+    Sums sums;
+    ranges[i].invalidIdSums(sums.first, sums.second);
+    return sums;
+  }, [](const Sums& a, const Sums& b) { return Sums(a.first + b.first, a.second + b.second); });
 
-  for (auto& range : ranges) {
-    range.invalidIdSums(part1, part2);
-  }
+  return { part1, part2 };
+}
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
 }
 
+REGISTER_SOLVER(2, day02::solve);
+SOLVER_MAIN(day02::solve)
@@ -1,13 +1,17 @@
 
 #include <common/task.hpp>
 #include <common/time.hpp>
-#include <common/stream.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/thread_pool.hpp>
 
-#include <ranges>
+#include <memory_resource>
 #include <algorithm>
 
+namespace day03 {
+
 struct Battery {
-  Battery(std::string ratings) : ratings(std::move(ratings)) {}
+  Battery(std::string_view ratings) : ratings(ratings) {}
 
   int64_t outputJoltage(int nBatteries) {
     auto begin = ratings.begin();
@@ -32,24 +36,28 @@ struct Battery {
 
 
 
-  std::string ratings;
+  std::string_view ratings; // points into the input
 };
 
 
-int main() {
-  common::Time t;
-  
-  auto batteries = stream::lines(task::input()) | std::views::transform([](std::string line) { return Battery(line); }) | std::ranges::to<std::vector>();
+registry::Result solve(std::string_view input) {
+  std::pmr::vector<Battery> batteries(&registry::arena());
+  for (auto line : input::lines(input)) {
+    batteries.emplace_back(line);
+  }
+  registry::parsed();
 
-  int64_t part1 = 0;
-  int64_t part2 = 0;
+  // OPTIMIZATION: Every line is a separate battery bank, so the lines are processed in parallel (in chunks of 16 lines,
+  //               because a single line is only a few hundred nanoseconds of work)
+  using Sums = std::pair<int64_t, int64_t>;
+  auto [part1, part2] = threads::parallelReduce(0, batteries.size(), Sums(), [&](size_t i) {
+    return Sums(batteries[i].outputJoltage(2), batteries[i].outputJoltage(12));
+  }, [](const Sums& a, const Sums& b) { return Sums(a.first + b.first, a.second + b.second); }, 16);
 
-  for (auto& battery : batteries) {
-    part1 += battery.outputJoltage(2);
-    part2 += battery.outputJoltage(12);
-  }
+  return { part1, part2 };
+}
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
 }
+
+REGISTER_SOLVER(3, day03::solve);
+SOLVER_MAIN(day03::solve)
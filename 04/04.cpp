@@ -1,18 +1,23 @@
 #include <common/task.hpp>
 #include <common/time.hpp>
-#include <common/field.hpp>
+#include <shared/padded_field.hpp>
+#include <shared/registry.hpp>
 
+namespace day04 {
 
-struct Warehouse : Field {
-  Warehouse(std::istream&& input) : Field(std::move(input)) {}
 
-  std::vector<Vector> collectAccessiblePaperRolls() const {
-    std::vector<Vector> accessiblePaperRolls;
-    for (size_t offset = 0; offset < data.size(); ++offset) {
-      if (data[offset] == '@') { // A paper roll
-        auto rollPos= fromOffset(offset);
-        if (isLocationAccessible(rollPos)) {
-          accessiblePaperRolls.push_back(rollPos);
+// OPTIMIZATION: The warehouse is surrounded by a border of empty floor, so the neighbours of every roll can be read
+//               with the precomputed offset strides without checking the field bounds.
+struct Warehouse : PaddedField {
+  Warehouse(std::string_view input) : PaddedField(input, '.') {}
+
+  /** Offsets of all paper rolls, which are accessible by a forklift */
+  std::vector<size_t> collectAccessiblePaperRolls() const {
+    std::vector<size_t> accessiblePaperRolls;
+    for (int y = 0; y < height; ++y) {
+      for (size_t offset = rowBegin(y), rowLast = rowEnd(y); offset < rowLast; ++offset) {
+        if (data[offset] == '@' && isLocationAccessible(offset)) { // A paper roll
+          accessiblePaperRolls.push_back(offset);
         }
       }
     }
@@ -22,39 +27,35 @@ struct Warehouse : Field {
 
 
 
-  /** Check whether a position is accessible by a forklift
+  /** Check whether a position is accessible by a forklift (fewer than 4 rolls around it)
    */
-  bool isLocationAccessible(const Vector& pos) const {
+  bool isLocationAccessible(size_t offset) const {
     int paperRolls = 0;
-    for (auto direction : Vector::AllDirections()) {
-      if (at(pos + direction) == '@') {
-        if (++paperRolls >= 4) {
-          return false;
-        }
-      }
+    for (auto neighbour : neighbours) {
+      paperRolls += data[offset + neighbour] == '@';
     }
 
-    return true;
+    return paperRolls < 4;
   }
 
 };
 
 
 
-int main() {
-  common::Time t;
-
-  Warehouse warehouse(task::input());
+registry::Result solve(std::string_view input) {
+  Warehouse warehouse(input);
+  registry::parsed();
 
 
   auto accessibleRolls = warehouse.collectAccessiblePaperRolls();
   int64_t part1 = accessibleRolls.size();
   int64_t part2 = 0;
+  registry::phase("part1");
 
   while (!accessibleRolls.empty()) {
     // Remove rolls
-    for (auto pos : accessibleRolls) {
-      warehouse[pos] = '.';
+    for (auto offset : accessibleRolls) {
+      warehouse.data[offset] = '.';
     }
 
     // Update removed count
@@ -66,7 +67,10 @@ int main() {
   
 
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+  return { part1, part2 };
+}
+
+}
+
+REGISTER_SOLVER(4, day04::solve);
+SOLVER_MAIN(day04::solve)
@@ -1,11 +1,14 @@
 
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/stream.hpp>
-#include <common/split.hpp>
-#include <common/string_view.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/thread_pool.hpp>
 
 #include <algorithm>
+#include <functional>
+
+namespace day05 {
 
 using Id = int64_t;
 
@@ -32,15 +35,19 @@ struct Range {
 
 
 struct Ingredients {
-  Ingredients(std::istream&& input) {
-    std::string line;
-    while(!(line = stream::line(input)).empty()) {
-      auto [start, end] = common::split2(line, '-');
-      fresh.push_back({ string_view::into<Id>(start), string_view::into<Id>(end)+1 });
+  Ingredients(std::string_view input) {
+    // The fresh ranges are separated from the available ids by an empty line
+    input::Scanner scanner(input);
+    while (!scanner.empty() && scanner.peek() != '\n' && scanner.peek() != '\r') {
+      auto begin = scanner.integer<Id>();
+      scanner.skip('-');
+      auto end = scanner.integer<Id>();
+      fresh.push_back({ begin, end + 1 });
+      scanner.nextLine();
     }
 
-    while (!(line = stream::line(input)).empty()) {
-      available.push_back(string_view::into<Id>(line));
+    for (scanner.skipWhitespace(); !scanner.empty(); scanner.skipWhitespace()) {
+      available.push_back(scanner.integer<Id>());
     }
 
     reorganize();
@@ -67,7 +74,7 @@ struct Ingredients {
   }
 
 
-  bool isFresh(Id id) {
+  bool isFresh(Id id) const {
     // Use binary search to faster find the matching range
     // we search for the first end ordered AFTER the id to find the range which contains the id
     auto pos = std::upper_bound(fresh.begin(), fresh.end(), id, [](Id id, const Range& range) { return id < range.end; });
@@ -81,22 +88,28 @@ struct Ingredients {
 
 
 
-int main() {
-  common::Time t;
-
+registry::Result solve(std::string_view input) {
   int64_t part1 = 0;
   int64_t part2 = 0;
 
-  Ingredients ingredients(task::input());
+  Ingredients ingredients(input);
+  registry::parsed();
 
-  part1 = std::ranges::count_if(ingredients.available, [&](Id id) { return ingredients.isFresh(id); });
+  // OPTIMIZATION: The ids are looked up in parallel. A lookup is just a binary search, so small inputs (below one chunk
+  //               of 4096 ids) stay on the current thread
+  auto& available = ingredients.available;
+  part1 = threads::parallelReduce(0, available.size(), int64_t(0), [&](size_t i) -> int64_t { return ingredients.isFresh(available[i]); }, std::plus<>(), 4096);
+  registry::phase("part1");
   
   for (auto& range : ingredients.fresh) {
     part2 += range.size();
   }
 
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+  return { part1, part2 };
+}
+
+}
+
+REGISTER_SOLVER(5, day05::solve);
+SOLVER_MAIN(day05::solve)
@@ -1,10 +1,13 @@
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/stream.hpp>
 #include <common/math.hpp>
 #include <common/string_view.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
 
-#include <ranges>
+#include <memory_resource>
+
+namespace day06 {
 
 int64_t add(int64_t a, int64_t b) {
   return a + b;
@@ -17,7 +20,7 @@ int64_t multiply(int64_t a, int64_t b) {
 using OperatorFn = int64_t (*)(int64_t a, int64_t b);
 
 struct Column {
-  Column(char op) : width(1), operatorFn(op == '*' ? multiply : add) {}
+  Column(char op, std::pmr::memory_resource* memory) : numbers(memory), operatorFn(op == '*' ? multiply : add), width(1) {}
 
   // Part 1
   int64_t simpleResult() const {
@@ -58,23 +61,26 @@ struct Column {
 
 
 
-  std::vector<std::string> numbers; // The full with numbers of the column (optionally with leading and/or trailing spaces)
+  std::pmr::vector<std::string_view> numbers; // The full with numbers of the column (optionally with leading and/or trailing spaces), pointing into the input
   OperatorFn operatorFn;
   int width; // the width of this column in digits/chars
 };
 
 
 struct Tasks {
-  Tasks(std::istream&& input) {
+  Tasks(std::string_view input, std::pmr::memory_resource* memory) : columns(memory) {
     // If we assume that we have the same amount of numbers in each row, we can just store all
     // numbers in one flat array and store the number of columns
 
     // First collect all the lines in a vector
-    auto numberLines = stream::lines(input) | std::ranges::to<std::vector>();
+    std::pmr::vector<std::string_view> numberLines(memory);
+    for (auto line : input::lines(input)) {
+      numberLines.push_back(line);
+    }
 
     // The last line will be the operator line, which will define the column width for each column,
     // so we will process it first
-    columns = processOperatorLine(numberLines.back());
+    processOperatorLine(numberLines.back(), memory);
     numberLines.pop_back();
 
     // Read all the numbers as strings (including whitespaces) into the columns
@@ -105,8 +111,7 @@ private:
   /** This method will determine the number of column, the width of each column and
    *  will store the operators to apply to each column
    */
-  static std::vector<Column> processOperatorLine(const std::string& line) {
-    std::vector<Column> columns;
+  void processOperatorLine(std::string_view line, std::pmr::memory_resource* memory) {
     for (auto ch : line) {
       if (ch == '*' || ch == '+') {
         // Next operator
@@ -115,28 +120,29 @@ private:
           --columns.back().width; 
         }
 
-        columns.push_back(ch);
+        columns.emplace_back(ch, memory);
       } else {
         // Otherwise this space is part of the previous column
         ++columns.back().width;
       }
     }
-    return columns;
   }
 
-  std::vector<Column> columns;
+  std::pmr::vector<Column> columns;
 };
 
 
 
 
-int main() {
-  common::Time t;
-
-  Tasks tasks(task::input());
+registry::Result solve(std::string_view input) {
+  Tasks tasks(input, &registry::arena());
+  registry::parsed();
   auto [part1,part2] = tasks.calculateResults();
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  return { part1, part2 };
 }
+
+}
+
+REGISTER_SOLVER(6, day06::solve);
+SOLVER_MAIN(day06::solve)
@@ -1,9 +1,15 @@
 #include <common/time.hpp>
 #include <common/task.hpp>
 #include <common/vector3d.hpp>
-#include <common/stream.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/profile.hpp>
+#include <shared/thread_pool.hpp>
+#include <memory_resource>
 #include <unordered_set>
 
+namespace day08 {
+
 
 namespace {
   int64_t squaredDistance(Vector3D a, Vector3D b) {
@@ -18,9 +24,13 @@ namespace {
 
 
 struct JunctionBox {
-  JunctionBox(std::istream&& input) {
-    char ch;
-    input >> position.x >> ch >> position.y >> ch >> position.z;
+  /** Parses "x,y,z" */
+  JunctionBox(input::Scanner& scanner) {
+    scanner.integer(position.x);
+    scanner.skip(',');
+    scanner.integer(position.y);
+    scanner.skip(',');
+    scanner.integer(position.z);
   }
 
   Vector3D position;
@@ -28,9 +38,10 @@ struct JunctionBox {
 
 
 struct Playground {
-  Playground(std::istream&& input) {
-    for (auto& line : stream::lines(input)) {
-      boxes.emplace_back(std::istringstream(line));
+  Playground(std::string_view input, std::pmr::memory_resource* memory) : boxes(memory) {
+    input::Scanner scanner(input);
+    for (scanner.skipWhitespace(); !scanner.empty(); scanner.skipWhitespace()) {
+      boxes.emplace_back(scanner);
     }
   }
 
@@ -38,6 +49,7 @@ struct Playground {
   std::pair<int64_t, int64_t> countCircuits() {
     std::vector<std::unordered_set<JunctionBox*>> circuits;
     auto sortedDistances = calculateSortedDistances();
+    registry::phase("preprocess");
 
     std::pair<int64_t, int64_t> results;
 
@@ -76,6 +88,7 @@ struct Playground {
         // Now sort circuits descending by size and save the size of the 3 larges circuits
         std::sort(circuits.begin(), circuits.end(), [](const auto& circuitA, const auto& circuitB) { return circuitA.size() > circuitB.size(); });
         results.first = circuits[0].size() * circuits[1].size() * circuits[2].size();
+        registry::phase("part1");
       }
     }
 
@@ -84,6 +97,7 @@ struct Playground {
 
 
   struct DistanceEntry {
+    DistanceEntry() = default;
     DistanceEntry(int a, int b, int64_t distance) : firstIndex(a), secondIndex(b), distance(distance) {}
     bool operator<(const DistanceEntry& other) const { return distance < other.distance; }
 
@@ -92,35 +106,44 @@ struct Playground {
     int64_t distance;
   };
 
-  std::vector<DistanceEntry> calculateSortedDistances() const {
-    std::vector<DistanceEntry> entries;
-    for (int i = 0; i < boxes.size(); ++i) {
+  std::pmr::vector<DistanceEntry> calculateSortedDistances() const {
+    PROFILE_SCOPE("calculateSortedDistances");
+    // Sized up front (also because growing would leave the smaller buffers unused in the arena)
+    size_t n = boxes.size();
+    std::pmr::vector<DistanceEntry> entries(n < 2 ? 0 : n * (n - 1) / 2, boxes.get_allocator());
+
+    // OPTIMIZATION: Each row of pairs is written to its own precomputed range of entries, so the rows are calculated
+    //               in parallel and the result doesn't depend on the number of threads
+    threads::parallelFor(0, n, [&](size_t i) {
       auto& firstBox = boxes[i];
+      auto entry = entries.begin() + (i * n - i * (i + 1) / 2); // rows before i have n-1, n-2, ... entries
       // start inner loop at i+1 to not check any distance twice
-      for (int j = i + 1; j < boxes.size(); ++j) {
+      for (auto j = i + 1; j < n; ++j) {
         auto& secondBox = boxes[j];
-        entries.emplace_back(i, j, squaredDistance(firstBox.position, secondBox.position));
+        *entry++ = DistanceEntry(static_cast<int>(i), static_cast<int>(j), squaredDistance(firstBox.position, secondBox.position));
       }
-    }
-    std::sort(entries.begin(), entries.end());
+    }, 8);
+    threads::parallelSort(entries.begin(), entries.end());
     return entries;
   }
 
 
-  std::vector<JunctionBox> boxes;
+  std::pmr::vector<JunctionBox> boxes;
 };
 
 
 
 
-int main() {
-  common::Time t;
-
-  Playground playground(task::input());
+registry::Result solve(std::string_view input) {
+  Playground playground(input, &registry::arena());
+  registry::parsed();
   auto [part1, part2] = playground.countCircuits();
 
   
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  return { part1, part2 };
 }
+
+}
+
+REGISTER_SOLVER(8, day08::solve);
+SOLVER_MAIN(day08::solve)
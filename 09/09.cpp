@@ -1,11 +1,18 @@
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/stream.hpp>
-#include <common/split.hpp>
-#include <common/string_view.hpp>
 #include <common/vector.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/profile.hpp>
+#include <shared/thread_pool.hpp>
 
 #include <optional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <atomic>
+
+namespace day09 {
 
 // Returns a simple direction (Up, Left, Right, Down) to get from 'from' to 'to'
 // The direction will point into 'to' with a length of 1.
@@ -106,10 +113,13 @@ std::ostream& operator<<(std::ostream& out, const Rectangle& r) {
 
 
 struct MovieTheater {
-  MovieTheater(std::istream&& input) {
-    for (auto& line : stream::lines(input)) {
-      auto [x, y] = common::split2(line, ',');
-      redTiles.emplace_back(string_view::into<int>(x), string_view::into<int>(y));
+  MovieTheater(std::string_view input) {
+    input::Scanner scanner(input);
+    for (scanner.skipWhitespace(); !scanner.empty(); scanner.skipWhitespace()) {
+      auto x = scanner.integer<int>();
+      scanner.skip(',');
+      auto y = scanner.integer<int>();
+      redTiles.emplace_back(x, y);
     }
 
     // Collect all lines as they are needed for Part two
@@ -122,7 +132,106 @@ struct MovieTheater {
       (line.horizontal() ? horizontalLines : verticalLines).push_back(line);
     }
 
-    // Now collect all rectangles with an area > 0 and sort them descending by area
+    // OPTIMIZATION: Sort the lines by their fixed coordinate (y for horizontal and x for vertical lines). This allows us to
+    //               only check the lines within the span of a rectangle's side using binary search in isRectangleInPolygon()
+    std::sort(horizontalLines.begin(), horizontalLines.end(), [](const Line& a, const Line& b) { return a.a.y < b.a.y; });
+    std::sort(verticalLines.begin(), verticalLines.end(), [](const Line& a, const Line& b) { return a.a.x < b.a.x; });
+  }
+
+  // Part 1
+  /** The largest rectangle between a pair p,q (with q right above p) can always be found among the points on the lower left
+   *  and upper right staircases of all points, because if any other point p' lies left and below p, then (p',q) is at least as
+   *  large as (p,q). The same goes for the upper left and lower right staircases for the rectangles along the other diagonal.
+   *  On large inputs these staircases only contain a small fraction of all points, so we don't need to check all pairs.
+   *
+   *  NOTE: Only checking the convex hull is not enough here. For the points (3,4), (13,2), (30,12), (17,27), (21,22) the
+   *        largest rectangle is (3,4)-(21,22), but (21,22) lies inside the hull.
+   *  NOTE: Since every red tile has a horizontal and a vertical neighbor, the largest rectangle is never an empty (1 wide)
+   *        one, so we don't need to filter these out here.
+   */
+  int64_t largestRectangleArea() const {
+    PROFILE_SCOPE("largestRectangleArea");
+    return std::max(
+      largestArea(staircase(redTiles, Vector(1, 1)), staircase(redTiles, Vector(-1, -1)), Vector(1, 1)),
+      largestArea(staircase(redTiles, Vector(1, -1)), staircase(redTiles, Vector(-1, 1)), Vector(1, -1))
+    );
+  }
+
+  /** Returns all points, which are not dominated by another point in the direction opposite to 'sign', i.e.
+   *  sign (1,1) returns the lower left staircase (no other point has both a smaller or equal x and y value)
+   */
+  static std::vector<Vector> staircase(std::vector<Vector> points, Vector sign) {
+    // Mirror the points, so that we always search for the lower left staircase
+    for (auto& point : points) {
+      point = Vector(point.x * sign.x, point.y * sign.y);
+    }
+    std::sort(points.begin(), points.end(), [](const Vector& a, const Vector& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+    std::vector<Vector> result;
+    auto minY = std::numeric_limits<int>::max();
+    for (auto& point : points) {
+      // Points are sorted by x, so a point is only part of the staircase if it is lower than all previous ones
+      if (point.y < minY) {
+        minY = point.y;
+        result.emplace_back(point.x * sign.x, point.y * sign.y); // mirror back
+      }
+    }
+    return result;
+  }
+
+  /** Returns the largest area between a point of first and a point of second, which lies right above it once both are
+   *  mirrored by sign (first is then the lower left and second the upper right staircase).
+   *
+   *  OPTIMIZATION: With both staircases sorted by x, the area (q.x - p.x + 1) * (q.y - p.y + 1) is a Monge array:
+   *                area(p, q) + area(p', q') >= area(p, q') + area(p', q) for p before p' and q before q'. The best q of
+   *                a later p therefore never lies before the best q of an earlier p, so a divide and conquer over first
+   *                only needs O((n + m) log n) areas instead of all n * m pairs. Pairs where q isn't right above p have no
+   *                positive area and never win (these rectangles are found along the other diagonal).
+   */
+  static int64_t largestArea(std::vector<Vector> first, std::vector<Vector> second, Vector sign) {
+    for (auto* points : { &first, &second }) {
+      for (auto& point : *points) {
+        point = Vector(point.x * sign.x, point.y * sign.y);
+      }
+      std::sort(points->begin(), points->end(), [](const Vector& a, const Vector& b) { return a.x < b.x; });
+    }
+    if (first.empty() || second.empty()) {
+      return 0;
+    }
+    return std::max<int64_t>(0, largestAreaInRange(first, second, 0, first.size(), 0, second.size() - 1));
+  }
+
+  /** Largest upRightArea() between first[begin, end) and second[minQ, maxQ] (see largestArea()) */
+  static int64_t largestAreaInRange(const std::vector<Vector>& first, const std::vector<Vector>& second, size_t begin, size_t end, size_t minQ, size_t maxQ) {
+    if (begin == end) {
+      return std::numeric_limits<int64_t>::min();
+    }
+
+    auto middle = (begin + end) / 2;
+    auto largest = std::numeric_limits<int64_t>::min();
+    auto bestQ = minQ;
+    for (auto q = minQ; q <= maxQ; ++q) {
+      auto candidate = upRightArea(first[middle], second[q]);
+      if (candidate > largest) {
+        largest = candidate;
+        bestQ = q;
+      }
+    }
+    return std::max({ largest,
+      largestAreaInRange(first, second, begin, middle, minQ, bestQ),
+      largestAreaInRange(first, second, middle + 1, end, bestQ, maxQ) });
+  }
+
+  /** Area between p and q if q lies right above p, otherwise zero or a negative value */
+  static int64_t upRightArea(Vector p, Vector q) {
+    return static_cast<int64_t>(q.x - p.x + 1) * (q.y - p.y + 1);
+  }
+
+
+  /** Collects all rectangles with an area > 0 sorted descending by area (needed for Part 2)
+   */
+  std::vector<Rectangle> sortedRectangles() const {
+    std::vector<Rectangle> rectangles;
     rectangles.reserve(redTiles.size());
     for (auto aPos = redTiles.begin(), end = redTiles.end(); aPos != end; ++aPos) {
       for (auto bPos = aPos + 1; bPos != end; ++bPos) {
@@ -135,24 +244,46 @@ struct MovieTheater {
     }
 
     std::sort(rectangles.begin(), rectangles.end(), [](const Rectangle& a, const Rectangle& b) { return a.area > b.area; });
-  }
-
-  // Part 1
-  int64_t largestRectangleArea() const {
-    return rectangles[0].area;
+    return rectangles;
   }
 
 
   // Part 2
+  /** Checks all rectangles largest to smallest, distributed in small chunks across the threads of the shared pool.
+   *  The chunks are handed out in descending area order and all threads share the index of the first (largest)
+   *  rectangle found so far. Since the candidates are sorted, every candidate after that index can't have a larger area,
+   *  so a worker stops as soon as its next candidate lies behind the current best index. The result is therefore always
+   *  the same as the first hit of a sequential search.
+   *
+   *  NOTE: forEachChunk() runs one worker loop per pool thread here instead of splitting the candidates itself, because
+   *        its contiguous per-thread blocks would let all but the first thread check small rectangles, which can't win.
+   */
   int64_t largestRectangleInPolygon() const {
-    // Check all rectangles largest to smallest
-    for (auto& rectangle : rectangles) {
-      if (isRectangleInPolygon(rectangle)) {
-        return rectangle.area;
+    PROFILE_SCOPE("largestRectangleInPolygon");
+    constexpr size_t CHUNK_SIZE = 64;
+    auto rectangles = sortedRectangles();
+
+    std::atomic<size_t> nextChunk = 0;
+    std::atomic<size_t> bestIndex = rectangles.size(); // index of the largest rectangle found so far
+
+    auto worker = [&]() {
+      for (size_t begin; (begin = nextChunk.fetch_add(CHUNK_SIZE)) < bestIndex.load(std::memory_order_relaxed);) {
+        auto end = std::min(begin + CHUNK_SIZE, rectangles.size());
+        for (auto i = begin; i < end && i < bestIndex.load(std::memory_order_relaxed); ++i) {
+          if (isRectangleInPolygon(rectangles[i])) {
+            // Lower the shared bound, unless another thread already found an even earlier candidate
+            auto current = bestIndex.load();
+            while (i < current && !bestIndex.compare_exchange_weak(current, i)) {}
+            break; // all following candidates of this chunk are smaller anyways
+          }
+        }
       }
-    }
+    };
+
+    auto workerCount = threads::pool().size();
+    threads::forEachChunk(0, workerCount, 1, [&](size_t, size_t, size_t) { worker(); });
 
-    return 0;
+    return bestIndex < rectangles.size() ? rectangles[bestIndex].area : 0;
   }
 
 
@@ -163,7 +294,7 @@ struct MovieTheater {
     // Check all rectangle sides for intersections with other lines inside the polygon
     for (auto [side, innerDir] : rectangle.getCheckSides()) {
       // Check for intersections of lines with the side (only check vertical lines for intersections with horizontal lines and vice versa)
-      for (auto& line : (side.horizontal() ? verticalLines : horizontalLines)) {
+      for (auto& line : perpendicularLinesInSpan(side)) {
         if (line.crossesLine(side, intersection)) {
           // Ignore intersection at the endpoints of the lines to check as these are the other sides of the rectangle
           if (!side.isEndPoint(intersection)) {
@@ -183,6 +314,24 @@ struct MovieTheater {
   }
 
 
+  /** Returns all lines perpendicular to the given side, whose fixed coordinate lies within the side's span.
+   *  Only these lines can possibly cross the side, all other lines can be skipped.
+   */
+  std::span<const Line> perpendicularLinesInSpan(const Line& side) const {
+    if (side.horizontal()) {
+      // Vertical lines are sorted by x
+      auto begin = std::lower_bound(verticalLines.begin(), verticalLines.end(), side.a.x, [](const Line& line, int x) { return line.a.x < x; });
+      auto end = std::upper_bound(begin, verticalLines.end(), side.b.x, [](int x, const Line& line) { return x < line.a.x; });
+      return { begin, end };
+    } else {
+      // Horizontal lines are sorted by y
+      auto begin = std::lower_bound(horizontalLines.begin(), horizontalLines.end(), side.a.y, [](const Line& line, int y) { return line.a.y < y; });
+      auto end = std::upper_bound(begin, horizontalLines.end(), side.b.y, [](int y, const Line& line) { return y < line.a.y; });
+      return { begin, end };
+    }
+  }
+
+
   static int64_t area(Vector a, Vector b) {
     auto delta = (a - b).apply([](int value) { return std::abs(value) + 1;});
     return static_cast<int64_t>(delta.x) * delta.y;
@@ -191,22 +340,24 @@ struct MovieTheater {
 
 
   std::vector<Vector> redTiles;
-  std::vector<Line> horizontalLines;
-  std::vector<Line> verticalLines;
-  std::vector<Rectangle> rectangles; // sorted by area (represented by the diagonal line)
+  std::vector<Line> horizontalLines; // sorted by y
+  std::vector<Line> verticalLines;   // sorted by x
 };
 
-int main() {
-  common::Time t;
-
+registry::Result solve(std::string_view input) {
   int64_t part1 = 0;
   int64_t part2 = 0;
 
-  MovieTheater theater(task::input());
+  MovieTheater theater(input);
+  registry::parsed();
   part1 = theater.largestRectangleArea();
+  registry::phase("part1");
   part2 = theater.largestRectangleInPolygon();
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+  return { part1, part2 };
+}
+
+}
+
+REGISTER_SOLVER(9, day09::solve);
+SOLVER_MAIN(day09::solve)
@@ -3,20 +3,217 @@
 #include <common/stream.hpp>
 #include <common/split.hpp>
 #include <common/string_view.hpp>
+#include <shared/registry.hpp>
+#include <shared/input.hpp>
+#include <shared/profile.hpp>
+#include <shared/flat_hash.hpp>
+#include <shared/thread_pool.hpp>
 
 #include <algorithm>
 #include <numeric>
-#include <execution>
-#include <set>
-
+#include <deque>
+#include <memory_resource>
+#include <chrono>
+#include <optional>
+#include <array>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+namespace day10 {
 
 constexpr int BITS = 12;
+constexpr int MAX_BUTTONS = 16; // the inputs have at most 13 buttons per machine
 
 // Comment in the following line and disable parallel processing or restrict input to only one machine to see 
 // the equation system being solved
 //#define LOG(x) std::cout << x
 #define LOG(x)
 
+// Use the fraction-free Bareiss elimination (simplifyBareiss) instead of the lcm based gaussian elimination (simplifyGaussian)
+constexpr bool FRACTION_FREE = true;
+
+// Set to true to print the wall time of each machine (slowest first) after solving
+constexpr bool PRINT_MACHINE_TIMES = false;
+
+// Set to true to load/store the Part 2 results of all machines from/into SOLUTION_CACHE_FILE between runs
+constexpr bool PERSIST_SOLUTION_CACHE = false;
+constexpr const char* SOLUTION_CACHE_FILE = "solution_cache.txt";
+
+// Set TRACE_ENABLED to 1 to compile in the trace points (otherwise they compile to nothing). Even then events are only recorded
+// if the environment variable AOC_TRACE is set to the output file. The events are written in the Chrome trace format
+// (open it in chrome://tracing or https://ui.perfetto.dev)
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+#if TRACE_ENABLED
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_START() trace::start()
+#define TRACE_FLUSH() trace::flush()
+#define TRACE_EVENT(name, value) trace::record(name, 'i', value)
+#define TRACE_SCOPE(name, value) trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name, value)
+#define TRACE_ONLY(x) x
+#else
+#define TRACE_START()
+#define TRACE_FLUSH()
+#define TRACE_EVENT(name, value)
+#define TRACE_SCOPE(name, value)
+#define TRACE_ONLY(x)
+#endif
+
+#if TRACE_ENABLED
+/** Each thread records its events into its own ring buffer without any locking. Only leasing a thread's buffer
+ *  (once per thread) takes a lock. A thread returns its buffer when it exits, so the workers started by later solves
+ *  reuse the buffers instead of adding new ones. The buffers are written out and emptied by flush() after all worker
+ *  threads have finished. If a thread records more than CAPACITY events, the oldest events are overwritten.
+ */
+namespace trace {
+  struct Event {
+    const char* name;
+    char phase; // 'B' = begin, 'E' = end, 'i' = instant (Chrome trace format)
+    int64_t value;
+    std::chrono::steady_clock::time_point time;
+  };
+
+  struct Buffer {
+    static constexpr size_t CAPACITY = 1 << 16;
+
+    Buffer(int threadId) : threadId(threadId), events(CAPACITY) {}
+
+    void push(const Event& event) {
+      auto pos = written.load(std::memory_order_relaxed);
+      events[pos % CAPACITY] = event;
+      written.store(pos + 1, std::memory_order_release);
+    }
+
+    int threadId;
+    std::vector<Event> events;
+    std::atomic<size_t> written = 0;
+    bool leased = false; // guarded by buffersMtx
+  };
+
+  inline bool enabled = false;
+  inline std::string outputPath;
+  inline std::chrono::steady_clock::time_point startTime;
+  inline std::mutex buffersMtx;
+  inline std::deque<Buffer> buffers; // deque doesn't move its elements when growing
+
+  /** Enables tracing if AOC_TRACE is set
+   */
+  inline void start() {
+    if (auto path = std::getenv("AOC_TRACE")) {
+      outputPath = path;
+      startTime = std::chrono::steady_clock::now();
+      enabled = true;
+    }
+  }
+
+  /** The buffer of the current thread, which is returned to the pool when the thread exits
+   */
+  struct BufferLease {
+    ~BufferLease() {
+      if (buffer) {
+        std::unique_lock<std::mutex> lock(buffersMtx);
+        buffer->leased = false;
+      }
+    }
+
+    Buffer* buffer = nullptr;
+  };
+
+  inline Buffer& threadBuffer() {
+    thread_local BufferLease lease;
+    if (!lease.buffer) {
+      std::unique_lock<std::mutex> lock(buffersMtx);
+      auto unused = std::ranges::find(buffers, false, &Buffer::leased);
+      lease.buffer = (unused != buffers.end()) ? &*unused : &buffers.emplace_back(static_cast<int>(buffers.size()));
+      lease.buffer->leased = true;
+    }
+    return *lease.buffer;
+  }
+
+  inline void record(const char* name, char phase, int64_t value) {
+    if (enabled) {
+      threadBuffer().push({ name, phase, value, std::chrono::steady_clock::now() });
+    }
+  }
+
+  /** Records a begin event on construction and the matching end event on destruction
+   */
+  struct Scope {
+    Scope(const char* name, int64_t value) : name(name) { record(name, 'B', value); }
+    ~Scope() { record(name, 'E', 0); }
+    const char* name;
+  };
+
+  /** Writes all recorded events as Chrome trace JSON into the file given by AOC_TRACE and empties the buffers.
+   *  Once a ring buffer has wrapped, the begin events of its oldest end events are lost, and scopes, which are still open,
+   *  have no end event yet. These unmatched events are dropped, because the trace viewers can't pair them.
+   */
+  inline void flush() {
+    if (!enabled) {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(buffersMtx);
+    std::ofstream out(outputPath);
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (auto& buffer : buffers) {
+      auto written = buffer.written.load(std::memory_order_acquire);
+      auto oldest = written - std::min(written, Buffer::CAPACITY);
+
+      // Pair the begin and end events (the scopes of a thread are properly nested)
+      std::vector<bool> matched(written - oldest, true);
+      std::vector<size_t> open;
+      for (auto pos = oldest; pos < written; ++pos) {
+        auto phase = buffer.events[pos % Buffer::CAPACITY].phase;
+        if (phase == 'B') {
+          open.push_back(pos);
+        } else if (phase == 'E') {
+          if (open.empty()) {
+            matched[pos - oldest] = false;
+          } else {
+            open.pop_back();
+          }
+        }
+      }
+      for (auto pos : open) {
+        matched[pos - oldest] = false;
+      }
+
+      for (auto pos = oldest; pos < written; ++pos) {
+        if (!matched[pos - oldest]) {
+          continue;
+        }
+        auto& event = buffer.events[pos % Buffer::CAPACITY];
+        auto micros = std::chrono::duration<double, std::micro>(event.time - startTime).count();
+        out << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << std::fixed << micros
+            << ",\"pid\":1,\"tid\":" << buffer.threadId;
+        if (event.phase == 'i') {
+          out << ",\"s\":\"t\"";
+        }
+        if (event.phase != 'E') {
+          out << ",\"args\":{\"value\":" << event.value << "}";
+        }
+        out << "}";
+        first = false;
+      }
+      buffer.written.store(0, std::memory_order_relaxed);
+    }
+    out << "\n]}\n";
+  }
+}
+#endif
+
 
 struct Configuration {
   Configuration() {
@@ -31,18 +228,10 @@ struct Configuration {
     this->c = c;
   }
 
-  Configuration(const Configuration& other) {
-    a = other.a;
-    b = other.b;
-    c = other.c;
-  }
-
-  Configuration& operator=(const Configuration& other) {
-    a = other.a;
-    b = other.b;
-    c = other.c;
-    return *this;
-  }
+  // Defaulted (trivial and noexcept), so that Machine stays nothrow movable and std::pmr::vector<Machine> moves the
+  // machines when growing instead of copying them (a copied Machine::buttons would allocate from the default resource)
+  Configuration(const Configuration& other) = default;
+  Configuration& operator=(const Configuration& other) = default;
 
 
   Configuration operator^(const Configuration& other) const {
@@ -77,16 +266,9 @@ struct Configuration {
     return *this;
   }
 
-  bool hasCommonBits(const Configuration& other) const {
-    return ((a & other.a) | (b & other.b) | (c & other.c)) != 0;
-  }
-
   bool operator==(const Configuration& other) const { return a == other.a && b == other.b && c == other.c; }
   bool operator!=(const Configuration& other) const { return a != other.a || b != other.b || c != other.c; }
 
-  // Some ordering necessary for set
-  bool operator<(const Configuration& other) const { return (a != other.a) ? a < other.a : (b != other.b) ? b < other.b : c < other.c; }
-
 
   union {
     struct { uint64_t a, b, c; };
@@ -105,8 +287,6 @@ std::ostream& operator<<(std::ostream& out, const Configuration& config) {
   return out << ')';
 }
 
-std::mutex outputMtx;
-
 struct Button {
   Button(int index) : index(index) {}
   Configuration pattern;
@@ -114,15 +294,52 @@ struct Button {
 };
 
 
-struct Equation {
-  Equation(int result, int nVariables) : result(result) {
-    factors.resize(nVariables, 0);
+/** A simple fixed capacity vector, which stores its elements inline to avoid any heap allocations
+ */
+template<typename T, int CAPACITY>
+struct InlineVector {
+  T* begin() { return data.data(); }
+  T* end() { return data.data() + count; }
+  const T* begin() const { return data.data(); }
+  const T* end() const { return data.data() + count; }
+
+  int size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  T& operator[](int index) { return data[index]; }
+  const T& operator[](int index) const { return data[index]; }
+  T& back() { return data[count - 1]; }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args) {
+    assert(count < CAPACITY);
+    return data[count++] = T(std::forward<Args>(args)...);
+  }
+
+  void erase(T* pos) {
+    std::move(pos + 1, end(), pos);
+    --count;
   }
 
+  std::array<T, CAPACITY> data;
+  int count = 0;
+};
+
+
+using Variables = std::array<int, MAX_BUTTONS>;
+
+
+/** The factors are stored inline with a fixed capacity of MAX_BUTTONS. Unused factors are always 0, which allows us to
+ *  perform all row operations on the whole array (which the compiler can vectorize) without caring about nVariables.
+ */
+struct Equation {
+  Equation() : nVariables(0), result(0) {}
+  Equation(int result, int nVariables) : nVariables(nVariables), result(result) {}
+
   /** Number of leading 0 factors in this equation
    */
   int leadingZeroes() const {
-    return std::distance(factors.begin(), std::find_if(factors.begin(), factors.end(), [](int factor) { return factor != 0; }));
+    return std::distance(factors.begin(), std::find_if(factors.begin(), factors.begin() + nVariables, [](int factor) { return factor != 0; }));
   }
 
   /** Checks whether this is a zero equation (i.e. all factors and result are zero)
@@ -142,18 +359,13 @@ struct Equation {
 
   
 
-  Equation& operator-=(const Equation& other) {
-    result -= other.result;
-    for (int i = 0; i < factors.size(); ++i) {
-      factors[i] -= other.factors[i];
+  /** Performs this = this * ownFactor - other * otherFactor in place (without creating any temporary equation)
+   */
+  void subtractScaled(int ownFactor, const Equation& other, int otherFactor) {
+    result = result * ownFactor - other.result * otherFactor;
+    for (int i = 0; i < MAX_BUTTONS; ++i) {
+      factors[i] = factors[i] * ownFactor - other.factors[i] * otherFactor;
     }
-    return *this;
-  }
-
-  Equation operator*(int factor) const {
-    Equation result(*this);
-    result *= factor;
-    return result;
   }
 
   Equation& operator*=(int factor) {
@@ -165,6 +377,34 @@ struct Equation {
   }
 
 
+  /** One fraction-free (Bareiss) elimination step, which removes the variable at column from this equation:
+   *  this = (pivot * this - this[column] * pivotEquation) / previousPivot
+   *  The division is always exact. The calculation is done in 64 bit and throws if the result doesn't fit into the factors anymore.
+   */
+  void eliminateFractionFree(const Equation& pivotEquation, int column, int64_t previousPivot) {
+    int64_t pivot = pivotEquation.factors[column];
+    int64_t factor = factors[column]; // even if this is 0 the equation must be scaled to keep the following divisions exact
+
+    auto eliminate = [&](int value, int pivotValue) {
+      auto numerator = pivot * value - factor * pivotValue;
+      assert(numerator % previousPivot == 0);
+      return checkedInt(numerator / previousPivot);
+    };
+
+    result = eliminate(result, pivotEquation.result);
+    for (int i = 0; i < MAX_BUTTONS; ++i) {
+      factors[i] = eliminate(factors[i], pivotEquation.factors[i]);
+    }
+  }
+
+  static int checkedInt(int64_t value) {
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+      throw std::overflow_error("Equation coefficient exceeds 32 bit");
+    }
+    return static_cast<int>(value);
+  }
+
+
   bool divisibleBy(int divisor) {
     return result % divisor == 0 && std::all_of(factors.begin(), factors.end(), [divisor](int factor) { return factor % divisor == 0; });
   }
@@ -185,13 +425,13 @@ struct Equation {
   /** This method will attempt to set this equation's first non-zero factor variable into variables from the
    *  ones already present there (the ones to the right of it)
    */
-  bool setVariable(std::vector<int>& variables, const std::vector<int>& maxVarValues) {
+  bool setVariable(Variables& variables, const Variables& maxVarValues) const {
     auto varIdx = leadingZeroes(); // the variable we are setting
 
     auto value = result;
     
     // Now subtract all factors right of the variable to set from the result
-    for (int i = varIdx + 1; i < factors.size(); ++i) {
+    for (int i = varIdx + 1; i < nVariables; ++i) {
       value -= factors[i] * variables[i];
     }
 
@@ -208,14 +448,15 @@ struct Equation {
 
 
 
-  std::vector<int> factors; // of the variables
+  std::array<int, MAX_BUTTONS> factors = {}; // of the variables
+  int nVariables;
   int result;
 };
 
 
 std::ostream& operator<<(std::ostream& out, const Equation& equ) {
-  for (auto factor : equ.factors) {
-    out << std::setw(3) << factor << " ";
+  for (int i = 0; i < equ.nVariables; ++i) {
+    out << std::setw(3) << equ.factors[i] << " ";
   }
   out << " |" << std::setw(4) << equ.result;
 
@@ -231,23 +472,15 @@ struct EquationSystem {
    *  and determines the number of free variables.
    */
   void simplifyGaussian() {
+    PROFILE_SCOPE("simplifyGaussian");
     // Sort the equations by free bits to the left
     std::sort(equations.begin(), equations.end());
 
-    // Limit all variables to the maximum joltage value for now
-    maxVarValues.resize(equations[0].factors.size(), maxResult());
-
-    // Initialize the column order to allow for undoing the swaps we perform here during simplification
-    columnOrder.resize(maxVarValues.size());
-    std::iota(columnOrder.begin(), columnOrder.end(), 0);
-
-    // Limit the max values to the max positive result that a variable contributes to
-    optimizeFreeVariableLimits();
-
+    initializeVariables();
 
-    auto totalVariables = equations[0].factors.size();
     for (int equationIdx = 0; equationIdx < equations.size(); ++equationIdx) {
       auto& equation = equations[equationIdx];
+      TRACE_EVENT("elimination step", equationIdx);
 
       LOG(*this << "\n\n");
 
@@ -262,14 +495,15 @@ struct EquationSystem {
       // First ensure that we have exactly equationIdx leading zeroes
       if (equation.leadingZeroes() > equationIdx) {
         // Find another column, which is non-zero (there must be one unless this is a zero line) - which we assume isn't
-        auto swapPos = std::find_if(equation.factors.begin(), equation.factors.end(), [](int factor) { return factor != 0; });
-        assert(swapPos != equation.factors.end());
+        auto swapPos = std::find_if(equation.factors.begin(), equation.factors.begin() + nVariables, [](int factor) { return factor != 0; });
+        assert(swapPos != equation.factors.begin() + nVariables);
         swapColumns(equationIdx, std::distance(equation.factors.begin(), swapPos));
 
         // Swapping columns can affect the sort order of the following equations -> re-sort
-        // Use a stable sort to not change this equations position in case a second one exists with the same number of leading zeroes.
-        // <-- to not invalidate our reference on the top
-        std::stable_sort(equations.begin(), equations.end());
+        // Only sort the following equations to not change this equation's position in case a second one exists with the same number of leading zeroes.
+        // <-- to not invalidate our reference on the top. The previous equations are not affected by the swap.
+        // (std::stable_sort would allocate a temporary buffer here)
+        std::sort(equations.begin() + equationIdx + 1, equations.end());
         LOG(*this << "\n\n");
       }
 
@@ -297,14 +531,97 @@ struct EquationSystem {
         auto otherLeadingFactor = otherEquation.factors[equationIdx];
         if (otherLeadingFactor != 0) {
           auto lcm = std::lcm(leadingFactor, otherLeadingFactor);
+          otherEquation.subtractScaled(lcm / otherLeadingFactor, equation, lcm / leadingFactor);
+        }
+      }
+    }
+
+    freeVariables = nVariables - equations.size();
+    TRACE_EVENT("free variables", freeVariables);
+  }
+
+  /** Alternative to simplifyGaussian() using the fraction-free Bareiss elimination. Each row operation divides by the previous
+   *  pivot, which is always exact, so all coefficients stay bounded by the determinants of the system's minors instead of growing with
+   *  each lcm multiplication. We eliminate above and below each pivot (Gauss-Jordan), so that in the end every equation only contains its
+   *  leading variable and free variables. This way setVariable() doesn't depend on other leading variables and every equation can
+   *  be back-substituted as soon as its free variables are set.
+   */
+  void simplifyBareiss() {
+    PROFILE_SCOPE("simplifyBareiss");
+    initializeVariables();
+
+    int64_t previousPivot = 1;
+    for (int pivotIdx = 0; pivotIdx < equations.size(); ++pivotIdx) {
+      LOG(*this << "\n\n");
+      TRACE_EVENT("elimination step", pivotIdx);
+
+      // Find a row with a non-zero factor in the pivot column, otherwise swap in another non-zero column
+      if (!selectPivot(pivotIdx)) {
+        // Only zero equations left, they contribute no information
+        while (equations.size() > pivotIdx) {
+          assert(equations.back().isZero());
+          equations.erase(&equations.back());
+        }
+        break;
+      }
+
+      auto& pivotEquation = equations[pivotIdx];
+      if (pivotEquation.factors[pivotIdx] < 0) {
+        pivotEquation *= -1; // keep the pivot positive
+      }
 
-          otherEquation *= (lcm / otherLeadingFactor);
-          otherEquation -= equation * (lcm / leadingFactor);
+      for (int otherIdx = 0; otherIdx < equations.size(); ++otherIdx) {
+        if (otherIdx != pivotIdx) {
+          equations[otherIdx].eliminateFractionFree(pivotEquation, pivotIdx, previousPivot);
         }
       }
+      previousPivot = pivotEquation.factors[pivotIdx];
     }
 
-    freeVariables = equations[0].factors.size() - equations.size();
+    // All leading factors are now the same (the determinant), reduce each equation by the gcd of its coefficients
+    // to keep the values small. For many equations this normalizes the leading factor to 1.
+    for (auto& equation : equations) {
+      auto divisor = std::reduce(equation.factors.begin(), equation.factors.end(), equation.result, [](int a, int b) { return std::gcd(a, b); });
+      if (divisor > 1) {
+        equation /= divisor;
+      }
+    }
+
+    LOG(*this << "\n\n");
+    freeVariables = nVariables - equations.size();
+    TRACE_EVENT("free variables", freeVariables);
+  }
+
+  /** Moves an equation with a non-zero factor at column pivotIdx to row pivotIdx. If no such equation exists, another column with a non-zero
+   *  factor is swapped in. Returns false if all remaining equations are zero.
+   */
+  bool selectPivot(int pivotIdx) {
+    for (int column = pivotIdx; column < nVariables; ++column) {
+      for (int row = pivotIdx; row < equations.size(); ++row) {
+        if (equations[row].factors[column] != 0) {
+          std::swap(equations[pivotIdx], equations[row]);
+          if (column != pivotIdx) {
+            swapColumns(pivotIdx, column);
+          }
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /** Sets the initial variable limits and column order for the simplification
+   */
+  void initializeVariables() {
+    // Limit all variables to the maximum joltage value for now
+    nVariables = equations[0].nVariables;
+    std::fill_n(maxVarValues.begin(), nVariables, maxResult());
+
+    // Initialize the column order to allow for undoing the swaps we perform here during simplification
+    std::iota(columnOrder.begin(), columnOrder.begin() + nVariables, 0);
+
+    // Limit the max values to the max positive result that a variable contributes to
+    optimizeFreeVariableLimits();
   }
 
   /** A simple optimization step reducing the range of variable values, which need to be checked by 
@@ -314,7 +631,7 @@ struct EquationSystem {
   void optimizeFreeVariableLimits() {
     for (auto& equation : equations) {
       if (equation.isPositive()) {
-        for (int i = 0; i < maxVarValues.size(); ++i) {
+        for (int i = 0; i < nVariables; ++i) {
           if (equation.factors[i] > 0) {
             auto div = std::div(equation.result, equation.factors[i]);
             auto newLimit = div.quot;
@@ -331,96 +648,252 @@ struct EquationSystem {
   }
 
 
-  /** Solve the gaussian equation by trying out all possible values for all free variables (only possible after simplifying the system)
+  /** Solve the simplified equation system by a depth first branch-and-bound search over the free variables (only possible after simplifying the system).
+   *  After each free variable is set, all equations, which only depend on already known variables are back-substituted immediately, so
+   *  non-integer or out of bounds values are detected as early as possible. Branches are pruned if they cannot beat the best step count
+   *  found so far or if an equation can no longer be satisfied within the variable limits.
    */
-  int solveMinSteps() {
+  int solveMinSteps(Variables* presses = nullptr) {
+    TRACE_SCOPE("solveMinSteps", freeVariables);
+    PROFILE_SCOPE("solveMinSteps");
     int minSteps = std::numeric_limits<int>::max();
 
-    std::vector<int> minVariables;
+    Variables minVariables = {};
 
-    std::vector<int> variables(equations[0].factors.size());
+    Variables variables = {};
 
     // Reduce the number of values to test by looking for equations with only positive coefficents to derive a lower limit
     // for out free variables
     optimizeFreeVariableLimits();
-    const int maxVarConfigs = totalFreeVarConfigs();
-    for (int config = 0; config < maxVarConfigs; ++config) {
-      // Set the variables for this run
-      setVariableConfig(variables, config);
+    determineReadyDepths();
+
+    TRACE_EVENT("estimated configurations", static_cast<int64_t>(estimatedCost()));
+
+    // Some equations might not depend on any free variable at all
+    int steps = 0;
+    if (substituteReadyEquations(0, variables, steps)) {
+      searchFreeVariables(0, variables, steps, minSteps, minVariables);
+    }
+    TRACE_EVENT("enumerated values", enumeratedValues);
 
+    if (minSteps != std::numeric_limits<int>::max()) {
+      LOG("\nButtons: " << stream::join(undoColumnSwaps(minVariables), ',') << "\n");
+      if (presses) {
+        std::ranges::copy(undoColumnSwaps(minVariables), presses->begin());
+      }
+    }
+
+    return minSteps;
+  }
+
+  /** Tries all values for the free variable at the given depth and recurses into the next free variable.
+   *  steps is the sum of all variables set so far.
+   */
+  void searchFreeVariables(int depth, Variables& variables, int steps, int& minSteps, Variables& minVariables) const {
+    if (depth == freeVariables) {
+      // All variables are set (the last free variable's equations have been substituted already)
+      if (steps < minSteps) {
+        minSteps = steps;
+        minVariables = variables;
+      }
+      return;
+    }
+
+    if (depth == freeVariables - 1) {
+      // The last free variable is the innermost loop
+      searchLastFreeVariable(depth, variables, steps, minSteps, minVariables);
+      return;
+    }
+
+    auto varIdx = equations.size() + depth;
+    // All variables are positive, so once the free variable alone reaches the best result, larger values won't be better
+    for (int value = 0; value <= maxVarValues[varIdx] && steps + value < minSteps; ++value) {
+      variables[varIdx] = value;
+      TRACE_ONLY(++enumeratedValues);
+
+      auto newSteps = steps + value;
+      if (substituteReadyEquations(depth + 1, variables, newSteps) && newSteps < minSteps && isFeasible(depth + 1, variables)) {
+        searchFreeVariables(depth + 1, variables, newSteps, minSteps, minVariables);
+      }
+    }
+  }
+
+  /** Same as searchFreeVariables() for the last free variable, but back-substitutes LANES values of that variable at once.
+   *  All lanes perform the same operations on independent values without any branches: the known part of each equation is
+   *  computed once per batch instead of once per value, and the fixed trip count lets the compiler unroll the lane loops.
+   *  The exact division by the leading factor (a runtime value) stays a scalar integer division per lane, so these loops are
+   *  not vectorized. Invalid values are masked out and the minimum step count is reduced across all lanes at the end of each batch.
+   */
+  void searchLastFreeVariable(int depth, Variables& variables, int steps, int& minSteps, Variables& minVariables) const {
+    constexpr int LANES = 16;
+    using Lanes = std::array<int, LANES>;
+
+    const int varIdx = equations.size() + depth;
+    const int level = depth + 1;
+
+    // True for all variables, which have different values in each lane (the last free variable and the equations depending on it)
+    auto isLaneVariable = [&](int idx) { return idx == varIdx || (idx < equations.size() && readyDepth[idx] == level); };
+
+    std::array<Lanes, MAX_BUTTONS> laneVariables;
+    for (int first = 0; first <= maxVarValues[varIdx] && steps + first < minSteps; first += LANES) {
+      TRACE_ONLY(enumeratedValues += LANES);
+      Lanes laneSteps;
+      std::array<bool, LANES> valid;
+      for (int lane = 0; lane < LANES; ++lane) {
+        laneVariables[varIdx][lane] = first + lane;
+        laneSteps[lane] = steps + first + lane;
+        valid[lane] = first + lane <= maxVarValues[varIdx];
+      }
 
-      bool validConfiguration = true;
       for (int i = equations.size(); i --> 0 ;) {
-        if (!equations[i].setVariable(variables, maxVarValues)) {
-          // Variable value out of bounds or not an integer
-          validConfiguration = false;
-          break;
+        if (readyDepth[i] != level) {
+          continue;
+        }
+
+        auto& equation = equations[i];
+
+        // The part of all variables known before this batch is the same for all lanes
+        int known = equation.result;
+        for (int j = i + 1; j < nVariables; ++j) {
+          if (!isLaneVariable(j)) {
+            known -= equation.factors[j] * variables[j];
+          }
+        }
+
+        Lanes value;
+        value.fill(known);
+        for (int j = i + 1; j < nVariables; ++j) {
+          if (equation.factors[j] != 0 && isLaneVariable(j)) {
+            for (int lane = 0; lane < LANES; ++lane) {
+              value[lane] -= equation.factors[j] * laneVariables[j][lane];
+            }
+          }
+        }
+
+        // Divide by the leading factor (the variable must be a non-negative integer within its limit)
+        const int leadingFactor = equation.factors[i];
+        const int limit = maxVarValues[i];
+        for (int lane = 0; lane < LANES; ++lane) {
+          auto quotient = value[lane] / leadingFactor;
+          valid[lane] = valid[lane] & (value[lane] % leadingFactor == 0) & (quotient >= 0) & (quotient <= limit);
+          laneVariables[i][lane] = quotient;
+          laneSteps[lane] += quotient;
         }
       }
 
-      if (validConfiguration) {
-        // All variables are set -> count the number of button presses (by simply adding up all variables values)
-        auto steps = std::reduce(variables.begin(), variables.end());
-        if (steps < minSteps) {
-          minSteps = steps;
-          minVariables = variables;
+      // Reduce the minimum across all valid lanes
+      int bestLane = -1;
+      for (int lane = 0; lane < LANES; ++lane) {
+        if (valid[lane] && laneSteps[lane] < minSteps) {
+          minSteps = laneSteps[lane];
+          bestLane = lane;
         }
       }
-    }
 
-    if (!minVariables.empty()) {
-      LOG("\nButtons: " << stream::join(undoColumnSwaps(minVariables), ',') << "\n");
+      if (bestLane >= 0) {
+        minVariables = variables;
+        for (int j = 0; j < nVariables; ++j) {
+          if (isLaneVariable(j)) {
+            minVariables[j] = laneVariables[j][bestLane];
+          }
+        }
+      }
     }
-
-    return minSteps;
   }
 
-  /** Reverses the column swaps performed during simplifyGaussian on the given variable result vector
-   *  to be able to display them in the original order
+  /** Back-substitutes all equations, which become ready after setting 'level' free variables (bottom to top)
+   *  and adds the resulting variable values to steps. Returns false if any of these variables can't be set.
    */
-  std::vector<int> undoColumnSwaps(const std::vector<int>& variables) const {
-    auto result = variables;
-    for (int i = 0; i < columnOrder.size(); ++i) {
-      result[columnOrder[i]] = variables[i];
+  bool substituteReadyEquations(int level, Variables& variables, int& steps) const {
+    for (int i = equations.size(); i --> 0 ;) {
+      if (readyDepth[i] == level) {
+        if (!equations[i].setVariable(variables, maxVarValues)) {
+          return false; // Variable value out of bounds or not an integer
+        }
+        steps += variables[i];
+      }
     }
-    return result;
+    return true;
   }
 
+  /** Checks whether all equations, which are not ready after setting 'level' free variables, can still be satisfied
+   *  by choosing the unknown variables within their limits.
+   */
+  bool isFeasible(int level, const Variables& variables) const {
+    for (int i = 0; i < equations.size(); ++i) {
+      if (readyDepth[i] <= level) {
+        continue; // already substituted
+      }
+
+      auto& equation = equations[i];
+      int64_t remaining = equation.result;
+      int64_t minValue = 0;
+      int64_t maxValue = 0;
+      for (int varIdx = i; varIdx < nVariables; ++varIdx) {
+        auto factor = equation.factors[varIdx];
+        if (factor == 0) {
+          continue;
+        }
 
-  // Forgetting the +1 also contributed to me wondering for a day why the solver fails for 3 equations (the ones with the most buttons)
+        if (isKnown(varIdx, level)) {
+          remaining -= factor * variables[varIdx];
+        } else {
+          auto limit = static_cast<int64_t>(factor) * maxVarValues[varIdx];
+          (factor > 0 ? maxValue : minValue) += limit;
+        }
+      }
 
-  /** Calculates the total number of steps to take from the number of free variables and the variable value limit
-   */ 
-  int totalFreeVarConfigs() const {
-    int steps = 1;
-    for (int varIdx = 0; varIdx < freeVariables; ++varIdx) {
-      steps *= (maxVarValues[maxVarValues.size() - varIdx - 1] + 1); // +1 because the max value is included in the possible values
+      if (remaining < minValue || remaining > maxValue) {
+        return false;
+      }
     }
-    return steps;
+    return true;
   }
 
+  /** True if the variable has already been set after setting 'level' free variables
+   */
+  bool isKnown(int varIdx, int level) const {
+    return (varIdx < equations.size()) ? readyDepth[varIdx] <= level : varIdx - static_cast<int>(equations.size()) < level;
+  }
 
-  // I initially implemented this function wrongly, which has cost me a day to figure out why certain equations are not being solved
-  // incidentially these where the equations with the most buttons, thus the most difficult to debug
+  /** Determines for each equation the number of free variables, which must be set before the equation's leading variable
+   *  can be back-substituted. This is the highest free variable the equation depends on either directly or indirectly
+   *  through another equation's leading variable.
+   */
+  void determineReadyDepths() {
+    readyDepth.fill(0);
+    for (int i = equations.size(); i --> 0 ;) {
+      auto& factors = equations[i].factors;
+      for (int varIdx = i + 1; varIdx < nVariables; ++varIdx) {
+        if (factors[varIdx] != 0) {
+          // Leading variables depend on the free variables of their equations, free variable n is ready at depth n+1
+          auto depth = (varIdx < equations.size()) ? readyDepth[varIdx] : varIdx - static_cast<int>(equations.size()) + 1;
+          readyDepth[i] = std::max(readyDepth[i], depth);
+        }
+      }
+    }
+  }
 
-  /** Increments the variable configuration to the next valid configuration to loop through all free variable settings
+  /** Reverses the column swaps performed during simplifyGaussian on the given variable result vector
+   *  to get the presses in the original button order
    */
-  void setVariableConfig(std::vector<int>& variables, int configIdx) const {
-    auto freeVarIdx = variables.size() - freeVariables;
-    for (auto i = 0; i < freeVarIdx; ++i) {
-      variables[i] = 0; // zero all previous variables (not strictly needed due to normlization)
+  std::vector<int> undoColumnSwaps(const Variables& variables) const {
+    std::vector<int> result(nVariables);
+    for (int i = 0; i < nVariables; ++i) {
+      result[columnOrder[i]] = variables[i];
     }
+    return result;
+  }
 
-    // Now update the free variables (if any)
-    for (auto freeVar = 0; freeVar < freeVariables; ++freeVar) {
-      int i = variables.size() - freeVariables + freeVar;
 
-      // Divide by the max value + 1 and the remainder will be the variable's value (+1, because the max value is included)
-      // The quotient will be carried over to the next variable
-      auto div = std::div(configIdx, maxVarValues[i]+1);
-      variables[i] = div.rem;
-      configIdx = div.quot;
+  /** Estimates the cost of solveMinSteps() as the number of free variable configurations (before pruning)
+   */
+  double estimatedCost() const {
+    double configs = 1;
+    for (int varIdx = equations.size(); varIdx < nVariables; ++varIdx) {
+      configs *= maxVarValues[varIdx] + 1;
     }
+    return configs;
   }
 
 
@@ -450,10 +923,13 @@ struct EquationSystem {
   }
 
 
-  std::vector<Equation> equations;
-  std::vector<int> maxVarValues; // set by simplifyGaussian()
-  std::vector<int> columnOrder;  // modified by swapColumns
+  InlineVector<Equation, BITS> equations; // dense row-major matrix (rows are stored inline)
+  Variables maxVarValues = {}; // set by simplifyGaussian()
+  Variables columnOrder = {};  // modified by swapColumns
+  int nVariables = 0;    // set by simplifyGaussian()
   int freeVariables = 0; // set by simplifyGaussian()
+  std::array<int, BITS> readyDepth = {}; // per equation: number of free variables to set before it can be substituted (set by solveMinSteps())
+  TRACE_ONLY(mutable int64_t enumeratedValues = 0;) // number of free variable values tried by solveMinSteps()
 };
 
 
@@ -465,85 +941,356 @@ std::ostream& operator<<(std::ostream& out, const EquationSystem& system) {
 }
 
 
+/** Solves the indicator light problem (Part 1) as linear equation system over GF(2). Pressing a button twice is the same
+ *  as not pressing it at all, so each button is either pressed once or not at all and the indicator lights are simply the XOR
+ *  of all pressed buttons' light masks. We bring the system into reduced row echelon form by XOR elimination, which gives us
+ *  one particular solution and a basis of the nullspace (the button combinations, which don't toggle any light).
+ *  Every solution is the particular solution XORed with some combination of the nullspace basis.
+ */
+struct ToggleSystem {
+  static_assert(MAX_BUTTONS <= 32, "button masks (solutions) are stored as uint32_t");
+
+  ToggleSystem(std::span<const uint32_t> buttonLights, uint32_t targetLights, int nLights) : nButtons(buttonLights.size()) {
+    // The rows and the button masks have fixed sizes
+    if (nButtons > MAX_BUTTONS || nLights > BITS) {
+      throw std::invalid_argument("Toggle system exceeds " + std::to_string(MAX_BUTTONS) + " buttons or " + std::to_string(BITS) + " lights");
+    }
+
+    // Build one row per light containing the buttons, which toggle that light
+    std::array<uint32_t, BITS> rows = {};
+    std::array<bool, BITS> results = {};
+    for (int light = 0; light < nLights; ++light) {
+      for (int button = 0; button < nButtons; ++button) {
+        if (buttonLights[button] & (1u << light)) {
+          rows[light] |= 1u << button;
+        }
+      }
+      results[light] = (targetLights >> light) & 1;
+    }
+
+    // Gauss-Jordan elimination (subtraction is XOR in GF(2))
+    std::array<int, BITS> pivotButton = {};
+    int rank = 0;
+    uint32_t freeButtons = 0;
+    for (int button = 0; button < nButtons; ++button) {
+      auto pivotPos = std::find_if(rows.begin() + rank, rows.begin() + nLights, [&](uint32_t row) { return row & (1u << button); });
+      if (pivotPos == rows.begin() + nLights) {
+        freeButtons |= 1u << button; // no pivot for this button -> free variable
+        continue;
+      }
+
+      auto pivotIdx = std::distance(rows.begin(), pivotPos);
+      std::swap(rows[rank], rows[pivotIdx]);
+      std::swap(results[rank], results[pivotIdx]);
+
+      for (int light = 0; light < nLights; ++light) {
+        if (light != rank && (rows[light] & (1u << button))) {
+          rows[light] ^= rows[rank];
+          results[light] ^= results[rank];
+        }
+      }
+      pivotButton[rank++] = button;
+    }
+
+    // The remaining zero rows must also have a zero result, otherwise the lights cannot be reached
+    assert(std::none_of(results.begin() + rank, results.begin() + nLights, [](bool result) { return result; }));
+
+    // The particular solution sets all free buttons to 0, so each pivot button is simply the row's result
+    for (int row = 0; row < rank; ++row) {
+      if (results[row]) {
+        particular |= 1u << pivotButton[row];
+      }
+    }
+
+    // One basis vector per free button: press the free button and all pivot buttons, which depend on it
+    for (int button = 0; button < nButtons; ++button) {
+      if (freeButtons & (1u << button)) {
+        uint32_t vector = 1u << button;
+        for (int row = 0; row < rank; ++row) {
+          if (rows[row] & (1u << button)) {
+            vector |= 1u << pivotButton[row];
+          }
+        }
+        nullspace[nullspaceSize++] = vector;
+      }
+    }
+  }
+
+  /** Returns the minimum number of buttons to press, which is the lowest hamming weight of all solutions
+   *  For large nullspaces we switch to a meet-in-the-middle search over the buttons themselves.
+   */
+  int minPresses(std::span<const uint32_t> buttonLights, uint32_t targetLights) const {
+    // Enumerating the nullspace costs 2^nullspaceSize, meet-in-the-middle costs 2 * 2^(nButtons/2)
+    if (nullspaceSize <= (nButtons + 1) / 2 + 1) {
+      return minPressesNullspace();
+    } else {
+      return minPressesMeetInTheMiddle(buttonLights, targetLights);
+    }
+  }
+
+  /** Enumerates all 2^nullspaceSize solutions in gray code order (each step only toggles a single basis vector)
+   */
+  int minPressesNullspace() const {
+    auto solution = particular;
+    int minPresses = std::popcount(solution);
+    for (uint32_t i = 1; i < (1u << nullspaceSize); ++i) {
+      solution ^= nullspace[std::countr_zero(i)];
+      minPresses = std::min(minPresses, std::popcount(solution));
+    }
+    return minPresses;
+  }
+
+  /** Splits the buttons into two halves and records the fewest presses for each light pattern reachable with the first half.
+   *  Then for each combination of the second half we can look up the fewest presses of the first half to reach the target.
+   */
+  int minPressesMeetInTheMiddle(std::span<const uint32_t> buttonLights, uint32_t targetLights) const {
+    constexpr uint8_t UNREACHABLE = std::numeric_limits<uint8_t>::max();
+    std::array<uint8_t, 1 << BITS> minFirstHalf;
+    minFirstHalf.fill(UNREACHABLE);
+
+    int half = nButtons / 2;
+    uint32_t lights = 0;
+    minFirstHalf[0] = 0;
+    for (uint32_t i = 1; i < (1u << half); ++i) {
+      // Gray code: the set of pressed buttons is i ^ (i >> 1)
+      lights ^= buttonLights[std::countr_zero(i)];
+      auto presses = static_cast<uint8_t>(std::popcount(i ^ (i >> 1)));
+      minFirstHalf[lights] = std::min(minFirstHalf[lights], presses);
+    }
+
+    int minPresses = std::numeric_limits<int>::max();
+    lights = 0;
+    for (uint32_t i = 0; i < (1u << (nButtons - half)); ++i) {
+      if (i > 0) {
+        lights ^= buttonLights[half + std::countr_zero(i)];
+      }
+      auto firstHalf = minFirstHalf[lights ^ targetLights];
+      if (firstHalf != UNREACHABLE) {
+        minPresses = std::min(minPresses, firstHalf + std::popcount(i ^ (i >> 1)));
+      }
+    }
+    return minPresses;
+  }
+
+
+  int nButtons;
+  uint32_t particular = 0; // button mask of one solution
+  std::array<uint32_t, MAX_BUTTONS> nullspace = {}; // button masks, which don't toggle any lights
+  int nullspaceSize = 0;
+};
+
+
+/** A machine's Part 2 problem in a normalized form, which is the same for machines that only differ in the order of their
+ *  buttons or indicator lights. The lights are sorted by joltage (and the number of buttons affecting them) and the buttons
+ *  are stored as sorted light masks over the sorted lights.
+ *  Lights, which can't be told apart this way keep their original order, so this is not a perfect canonical form, but
+ *  machines with the same form are always equivalent.
+ */
+struct CanonicalMachine {
+  bool operator==(const CanonicalMachine& other) const = default;
+
+  /** Checks that pressing each button presses[i] times reaches the joltages in exactly steps presses
+   */
+  bool isSolvedBy(const Variables& presses, int64_t steps) const {
+    std::array<int64_t, BITS> sums = {};
+    int64_t total = 0;
+    for (int buttonIdx = 0; buttonIdx < nButtons; ++buttonIdx) {
+      if (presses[buttonIdx] < 0) {
+        return false;
+      }
+      total += presses[buttonIdx];
+      for (int i = 0; i < nBits; ++i) {
+        if (buttons[buttonIdx] & (1 << i)) {
+          sums[i] += presses[buttonIdx];
+        }
+      }
+    }
+    return total == steps && std::equal(sums.begin(), sums.begin() + nBits, joltages.begin());
+  }
+
+  std::array<int16_t, BITS> joltages = {};
+  std::array<uint16_t, MAX_BUTTONS> buttons = {}; // light masks
+  int nBits = 0;
+  int nButtons = 0;
+};
+
+struct CanonicalMachineHash {
+  size_t operator()(const CanonicalMachine& machine) const {
+    // FNV-1a over all values
+    uint64_t hash = 14695981039346656037ull;
+    auto combine = [&](uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+    for (auto joltage : machine.joltages) {
+      combine(static_cast<uint16_t>(joltage));
+    }
+    for (auto button : machine.buttons) {
+      combine(button);
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+
+/** Cache of Part 2 results for machines in their canonical form, which can be persisted to disk. Every result is stored
+ *  with its presses per canonical button, so entries loaded from disk can be checked against their machine.
+ *  NOTE: Only used by the thread calling Factory::solve() (before and after the parallel part), so it needs no locking.
+ */
+struct SolutionCache {
+  struct Solution {
+    int64_t steps = 0;
+    Variables presses = {}; // per canonical button
+  };
+
+  const Solution* find(const CanonicalMachine& machine) const {
+    auto pos = solutions.find(machine);
+    return (pos != solutions.end()) ? &pos->second : nullptr;
+  }
+
+  void insert(const CanonicalMachine& machine, const Solution& solution) {
+    assert(machine.isSolvedBy(solution.presses, solution.steps));
+    solutions.emplace(machine, solution);
+  }
+
+  /** Each line contains the joltages, the button masks, the result and the presses per button: "3,5,4,7 1,3,10,12 10 1,3,0,6"
+   *  A missing file simply leaves the cache empty. Lines, which don't describe a valid solution of their machine, are skipped,
+   *  so a stale or corrupted file can't produce wrong results.
+   */
+  void load(const char* path) {
+    for (auto& line : stream::lines(std::ifstream(path))) {
+      auto parts = common::split(line, ' ');
+      if (parts.size() != 4) {
+        continue; // skip invalid lines
+      }
+      auto joltages = common::split(parts[0], ',');
+      auto buttons = common::split(parts[1], ',');
+      auto presses = common::split(parts[3], ',');
+      if (joltages.size() > BITS || buttons.size() > MAX_BUTTONS || presses.size() != buttons.size()) {
+        continue; // skip machines, which don't fit into a CanonicalMachine or don't have a press count per button
+      }
+
+      CanonicalMachine machine;
+      for (auto joltage : joltages) {
+        machine.joltages[machine.nBits++] = string_view::into<int16_t>(joltage);
+      }
+      for (auto button : buttons) {
+        machine.buttons[machine.nButtons++] = string_view::into<uint16_t>(button);
+      }
+      Solution solution{ string_view::into<int64_t>(parts[2]) };
+      for (size_t i = 0; i < presses.size(); ++i) {
+        solution.presses[i] = string_view::into<int>(presses[i]);
+      }
+
+      bool validMasks = std::all_of(machine.buttons.begin(), machine.buttons.begin() + machine.nButtons, [&](uint16_t mask) { return mask < (1u << machine.nBits); });
+      if (validMasks && machine.isSolvedBy(solution.presses, solution.steps)) {
+        solutions.emplace(machine, solution);
+      }
+    }
+  }
+
+  void save(const char* path) const {
+    std::ofstream out(path);
+    for (auto& [machine, solution] : solutions) {
+      out << stream::join(std::span(machine.joltages.begin(), machine.nBits), ',') << ' '
+          << stream::join(std::span(machine.buttons.begin(), machine.nButtons), ',') << ' '
+          << solution.steps << ' '
+          << stream::join(std::span(solution.presses.begin(), machine.nButtons), ',') << '\n';
+    }
+  }
+
+  size_t size() const {
+    return solutions.size();
+  }
+
+private:
+  std::unordered_map<CanonicalMachine, Solution, CanonicalMachineHash> solutions;
+};
+
+
 namespace {
   int nextIndex = 0;
 }
 
 struct Machine {
-  Machine(std::string_view line) : index(nextIndex++), nBits(0) {
+  Machine(std::string_view line, std::pmr::memory_resource* memory) : buttons(memory), nBits(0), index(nextIndex++) {
     auto pos = line.begin();
     auto end = line.end();
     ++pos;
 
+    // The lights, buttons and joltages are stored in fixed size arrays, so larger machines are rejected up front
     int indicatorIdx = 0;
     for (; *pos != ']'; ++pos) {
+      if (indicatorIdx == BITS) {
+        throw std::runtime_error("Machine has more than " + std::to_string(BITS) + " indicator lights");
+      }
       indicators.bit[indicatorIdx++] = *pos == '#' ? 1 : 0;
     }
 
     int buttonIdx = 0;
     pos += 2; // consume "] "
     for (; *pos == '('; pos += 2) { // +=2 to consume ") "
+      if (buttonIdx == MAX_BUTTONS) {
+        throw std::runtime_error("Machine has more than " + std::to_string(MAX_BUTTONS) + " buttons");
+      }
       buttons.push_back(buttonIdx++);
       auto& button = buttons.back();
 
       auto closingParen = std::find(pos, end, ')');
-      int bit = 0;
-      for (auto number : common::split(std::string_view(pos + 1, closingParen), ',')) {
-        button.pattern.bit[string_view::into<uint8_t>(number)] = 1;
-      }
+      input::Scanner(std::string_view(pos + 1, closingParen)).list<int>(',', [&](int light) {
+        if (light < 0 || light >= indicatorIdx) {
+          throw std::runtime_error("Button toggles unknown light " + std::to_string(light));
+        }
+        button.pattern.bit[light] = 1;
+      });
       pos = closingParen;
     }
 
     assert(*pos == '{');
     auto endBrace = std::find(pos, end, '}');
-    indicatorIdx = 0;
-    for (auto joltage : common::split(std::string_view(pos + 1, endBrace), ',')) {
-      joltages.bit[indicatorIdx++] = string_view::into<int16_t>(joltage);
-      ++nBits;
-    }
+    input::Scanner(std::string_view(pos + 1, endBrace)).list<int16_t>(',', [&](int16_t joltage) {
+      if (nBits == BITS) {
+        throw std::runtime_error("Machine has more than " + std::to_string(BITS) + " joltages");
+      }
+      joltages.bit[nBits++] = joltage;
+    });
   }
 
-  // Part 1 - find the minumum number of button presses by performing a simple BFS
+  // Part 1 - solve the toggle system over GF(2) (see ToggleSystem)
   int minButtonPresses() const {
-    std::set<Configuration> expanded = { Configuration() };
-    std::vector<Configuration> current;
-    std::vector<Configuration> next = { Configuration() };
-
-    auto targetState = indicators;
-    for (int presses = 1; true; ++presses) {
-      std::swap(current, next);
-      next.clear();
-
-      assert(!current.empty());
-      for (auto& configuration : current) {
-        // Get all the bits, which still need to be toggled
-        auto configDelta = configuration ^ targetState;
-        for (auto& button : buttons) {
-          // Only consider buttons, which contribute at least one indicator light towards the target state
-          if (button.pattern.hasCommonBits(configDelta)) {
-            auto newConfig = configuration ^ button.pattern;
-            if (newConfig == targetState) {
-              return presses; // found the shortest number of button presses
-            }
-            if (expanded.insert(newConfig).second) {
-              // First time reaching that state
-              next.push_back(newConfig);
-            }
-          }
-        }
-      }
+    PROFILE_SCOPE("minButtonPresses");
+    std::array<uint32_t, MAX_BUTTONS> buttonLights;
+    for (int i = 0; i < buttons.size(); ++i) {
+      buttonLights[i] = lightMask(buttons[i].pattern);
     }
 
-    return 0;
+    auto lights = std::span(buttonLights.begin(), buttons.size());
+    auto target = lightMask(indicators);
+    return ToggleSystem(lights, target, nBits).minPresses(lights, target);
   }
 
+  /** Converts the first nBits bits of the configuration into a bit mask
+   */
+  uint32_t lightMask(const Configuration& config) const {
+    uint32_t mask = 0;
+    for (int i = 0; i < nBits; ++i) {
+      if (config.bit[i]) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+  }
 
   // Part 2 - second attempt
   int64_t solveForJoltages() const {
     // Try solving using gaussian eliminiation technique...
-    EquationSystem system;
+    auto system = simplifiedEquationSystem();
+    return system.solveMinSteps();
+  }
 
-    common::Time t;
+  /** Converts the buttons and joltages into an equation system and simplifies it (see solveForJoltages())
+   */
+  EquationSystem simplifiedEquationSystem() const {
+    TRACE_SCOPE("simplify", index);
+    PROFILE_SCOPE("simplify");
+    EquationSystem system;
 
     // Convert the buttons and target value into an equation system
     for (int i = 0; i < nBits; ++i) {
@@ -557,20 +1304,64 @@ struct Machine {
       }
     }
 
-    system.simplifyGaussian();
+    if constexpr (FRACTION_FREE) {
+      system.simplifyBareiss();
+    } else {
+      system.simplifyGaussian();
+    }
     LOG(system << "\n");
-
-    auto result = system.solveMinSteps();
-    // std::unique_lock<std::mutex> lock(outputMtx);
-    // std::cout << "Machine[" << index << "] = " << result << " after " << t;
-    return result;
+    return system;
   }
 
 
 
+  /** Returns the normalized form of this machine's Part 2 problem (see CanonicalMachine). If buttonOrder is given, it
+   *  receives the original index of every canonical button.
+   */
+  CanonicalMachine canonicalForm(std::array<int, MAX_BUTTONS>* buttonOrder = nullptr) const {
+    PROFILE_SCOPE("canonicalForm");
+    CanonicalMachine canonical;
+    canonical.nBits = nBits;
+    canonical.nButtons = buttons.size();
+
+    // Sort lights by joltage and the number of buttons affecting them
+    auto buttonCount = [&](int light) { return std::ranges::count_if(buttons, [&](const Button& button) { return button.pattern.bit[light] != 0; }); };
+    std::array<int, BITS> lightOrder;
+    std::iota(lightOrder.begin(), lightOrder.begin() + nBits, 0);
+    std::stable_sort(lightOrder.begin(), lightOrder.begin() + nBits, [&](int a, int b) {
+      return joltages.bit[a] != joltages.bit[b] ? joltages.bit[a] < joltages.bit[b] : buttonCount(a) < buttonCount(b);
+    });
+
+    for (int i = 0; i < nBits; ++i) {
+      canonical.joltages[i] = joltages.bit[lightOrder[i]];
+    }
+
+    // Now convert the buttons into masks over the sorted lights and sort them
+    std::array<uint16_t, MAX_BUTTONS> masks = {};
+    for (int buttonIdx = 0; buttonIdx < buttons.size(); ++buttonIdx) {
+      for (int i = 0; i < nBits; ++i) {
+        if (buttons[buttonIdx].pattern.bit[lightOrder[i]]) {
+          masks[buttonIdx] |= 1 << i;
+        }
+      }
+    }
+    std::array<int, MAX_BUTTONS> order;
+    std::iota(order.begin(), order.begin() + canonical.nButtons, 0);
+    std::sort(order.begin(), order.begin() + canonical.nButtons, [&](int a, int b) { return masks[a] < masks[b]; });
+    for (int i = 0; i < canonical.nButtons; ++i) {
+      canonical.buttons[i] = masks[order[i]];
+    }
+
+    if (buttonOrder) {
+      *buttonOrder = order;
+    }
+    return canonical;
+  }
+
+
   /** Calculates the sum of all buttons
    */
-  static Configuration buttonSum(const std::vector<Button>& buttons) {
+  static Configuration buttonSum(const std::pmr::vector<Button>& buttons) {
     Configuration sum;
     for (auto& button : buttons) {
       sum += button.pattern;
@@ -580,54 +1371,174 @@ struct Machine {
 
 
   Configuration indicators;
-  std::vector<Button> buttons;
+  std::pmr::vector<Button> buttons;
   Configuration joltages;
   int nBits; // number of indicator bits/joltage values in this machine
   int index;
 };
 
+// Otherwise growing the machines vector copies the machines and their buttons end up outside of the arena
+static_assert(std::is_nothrow_move_constructible_v<Machine>);
+
 
 
 struct Factory {
-  Factory(std::istream&& input) {
-    for (auto line : stream::lines(input)) {
-      if (!std::string_view(line).starts_with("//") && !line.empty()) { // to support comments in the input file
-        machines.emplace_back(line);
+  Factory(std::string_view input, std::pmr::memory_resource* memory) : machines(memory) {
+    nextIndex = 0; // machine numbers start at 0 for every run of the solver within the same process
+    for (auto line : input::lines(input)) {
+      if (!line.starts_with("//") && !line.empty()) { // to support comments in the input file
+        machines.emplace_back(line, memory);
       }
     }
   }
 
-  // Part 1
-  int minButtonPresses() const {
-    std::vector<int> presses(machines.size());
+  struct MachineResult {
+    int presses = 0;         // Part 1
+    int64_t joltageSteps = 0; // Part 2
+    int freeVariables = 0;
+    double estimatedCost = 0;
+    std::chrono::steady_clock::duration time{};
+  };
+
+  // Part 1 & Part 2
+  /** Solves both parts for all machines in parallel. The cost of a machine varies by orders of magnitude depending on the
+   *  number of free variables and their limits, so we first simplify all equation systems to estimate their cost and then
+   *  schedule the most expensive machines first. Both parts of a machine are solved by the same task to keep its data in the cache.
+   *
+   *  Equivalent machines have the same Part 2 result, so the machines are grouped by their canonical form before anything
+   *  is simplified. Only one machine per group is solved (and none if the cache already knows the result), the other
+   *  machines of the group only solve Part 1 and get the Part 2 result of their group afterwards.
+   *
+   *  The machines are submitted to the shared thread pool in the order of their estimated cost. The pool runs its tasks
+   *  first in first out, so the most expensive machines start first and the cheap ones fill the gaps at the end.
+   */
+  std::pair<int64_t, int64_t> solve() {
+    results.assign(machines.size(), MachineResult());
+    flat::HashMap<CanonicalMachine, int, CanonicalMachineHash> groups(machines.size());
+    std::vector<int> groupOf(machines.size());
+    std::vector<int> representatives; // per group: the machine, which is solved for the group
+    std::vector<std::array<int, MAX_BUTTONS>> buttonOrders; // per group: the representative's original button per canonical button
+    std::vector<std::optional<SolutionCache::Solution>> groupSolutions;
+    for (int i = 0; i < machines.size(); ++i) {
+      std::array<int, MAX_BUTTONS> buttonOrder;
+      auto canonical = machines[i].canonicalForm(&buttonOrder);
+      auto [pos, inserted] = groups.insert(canonical, static_cast<int>(representatives.size()));
+      if (inserted) {
+        representatives.push_back(i);
+        buttonOrders.push_back(buttonOrder);
+        auto cached = cache.find(canonical);
+        groupSolutions.push_back(cached ? std::optional(*cached) : std::nullopt);
+      }
+      groupOf[i] = pos->second;
+    }
 
-    std::transform(std::execution::par_unseq, machines.begin(), machines.end(), presses.begin(), [](const Machine& machine) { return machine.minButtonPresses(); });
-    return std::reduce(presses.begin(), presses.end());
+    std::vector<EquationSystem> systems(representatives.size());
+    for (int group = 0; group < representatives.size(); ++group) {
+      if (!groupSolutions[group]) {
+        auto machineIdx = representatives[group];
+        systems[group] = machines[machineIdx].simplifiedEquationSystem();
+        results[machineIdx].freeVariables = systems[group].freeVariables;
+        results[machineIdx].estimatedCost = systems[group].estimatedCost();
+      }
+    }
+
+    std::vector<int> order(machines.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return results[a].estimatedCost > results[b].estimatedCost; });
+
+    threads::TaskGroup tasks;
+    for (auto machineIdx : order) {
+      tasks.run([&, machineIdx] {
+        TRACE_SCOPE("machine", machines[machineIdx].index);
+        PROFILE_SCOPE("machine");
+        auto start = std::chrono::steady_clock::now();
+        auto& result = results[machineIdx];
+        result.presses = machines[machineIdx].minButtonPresses();
+
+        // Only the representative of a group writes the group's result, which is read after all tasks have finished
+        auto group = groupOf[machineIdx];
+        if (representatives[group] == machineIdx && !groupSolutions[group]) {
+          Variables presses = {};
+          SolutionCache::Solution solution{ systems[group].solveMinSteps(&presses) };
+          for (size_t i = 0; i < machines[machineIdx].buttons.size(); ++i) {
+            solution.presses[i] = presses[buttonOrders[group][i]];
+          }
+          groupSolutions[group] = solution;
+        }
+        result.time = std::chrono::steady_clock::now() - start;
+      });
+    }
+    tasks.wait();
+
+    for (auto& [canonical, group] : groups) {
+      if (groupSolutions[group]->steps != std::numeric_limits<int>::max()) { // machines without a solution aren't cached
+        cache.insert(canonical, *groupSolutions[group]);
+      }
+    }
+
+    std::pair<int64_t, int64_t> total;
+    for (int i = 0; i < machines.size(); ++i) {
+      auto& result = results[i];
+      auto& representative = results[representatives[groupOf[i]]];
+      result.joltageSteps = groupSolutions[groupOf[i]]->steps;
+      result.freeVariables = representative.freeVariables;
+      result.estimatedCost = representative.estimatedCost;
+      total.first += result.presses;
+      total.second += result.joltageSteps;
+    }
+    return total;
   }
 
-  // Part 2
-  int64_t solveForJoltages() const {
-    std::vector<int64_t> presses(machines.size());
-    std::transform(std::execution::par_unseq, machines.begin(), machines.end(), presses.begin(), [](const Machine& machine) { return machine.solveForJoltages(); });
-    return std::reduce(presses.begin(), presses.end());
+  /** Prints the wall time of each machine from the last solve() call (slowest first)
+   */
+  void printMachineTimes(std::ostream& out) const {
+    std::vector<int> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return results[a].time > results[b].time; });
+
+    for (auto machineIdx : order) {
+      auto& result = results[machineIdx];
+      out << "Machine[" << machines[machineIdx].index << "] = " << result.joltageSteps << " after "
+          << std::chrono::duration<double, std::milli>(result.time).count() << "ms"
+          << " (free variables: " << result.freeVariables << ", estimated cost: " << result.estimatedCost << ")\n";
+    }
   }
 
-  std::vector<Machine> machines;
+  std::pmr::vector<Machine> machines;
+  std::vector<MachineResult> results; // per machine (set by solve())
+  SolutionCache cache;
 };
 
 
-int main() {
-  common::Time t;
+registry::Result solve(std::string_view input) {
+  TRACE_START();
 
   int64_t part1 = 0;
   int64_t part2 = 0;
 
-  Factory factory(task::input());
+  auto allocationsBefore = alloc::snapshot();
+  auto reservedBefore = registry::arena().bytesReserved();
+  Factory factory(input, &registry::arena());
+  // All parsed data lives in the arena, so parsing only allocates from the heap when the arena needs another chunk
+  assert(!alloc::ENABLED || registry::arena().bytesReserved() != reservedBefore || (alloc::snapshot() - allocationsBefore).allocations == 0);
+  registry::parsed();
+  if (PERSIST_SOLUTION_CACHE) {
+    factory.cache.load(SOLUTION_CACHE_FILE);
+  }
+
+  std::tie(part1, part2) = factory.solve();
+  if (PERSIST_SOLUTION_CACHE) {
+    factory.cache.save(SOLUTION_CACHE_FILE);
+  }
 
-  part1 = factory.minButtonPresses();
-  part2 = factory.solveForJoltages();
+  if (PRINT_MACHINE_TIMES) {
+    factory.printMachineTimes(std::cout);
+  }
+  TRACE_FLUSH();
+  return { part1, part2 };
+}
+
+}
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+REGISTER_SOLVER(10, day10::solve);
+SOLVER_MAIN(day10::solve)
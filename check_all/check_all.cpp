@@ -2,17 +2,43 @@
 #include <fstream>
 #include <vector>
 #include <optional>
-#include <regex>
 #include <cassert>
 #include <thread>
 #include <iomanip>
+#include <sstream>
 
 #include <common/stream.hpp>
-
+#include <shared/registry.hpp>
+#include <shared/results.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <filesystem>
+#include <cmath>
+#include <charconv>
+#include <mutex>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX // otherwise the min/max macros break std::min and std::max
+#endif
 #include <windows.h>
+#else
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif
 
-std::regex resultsRegex("^(//.*)|(\"([^\"]+)\"|([^,]+))(,(\"([^\"]+)\"|(.*)))?$");
-std::vector<std::optional<std::pair<std::string, std::optional<std::string>>>> results;
+std::vector<results::Expected> expectedResults;
 
 #ifdef _DEBUG
 #define CONFIG "Debug"
@@ -20,29 +46,118 @@ std::vector<std::optional<std::pair<std::string, std::optional<std::string>>>> r
 #define CONFIG "Release"
 #endif
 
+#ifdef _WIN32
+#define RESULTS_PATH "..\\data\\results.txt"
+#define DEFAULT_BIN_DIR "..\\x64\\" CONFIG "\\"
+#else
+#define RESULTS_PATH "../data/results.txt"
+#define DEFAULT_BIN_DIR "../bin/"
+#endif
+
+
+struct Options {
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency()); // number of tasks to run concurrently
+  std::chrono::seconds timeout{ 60 }; // per task
+  std::string binDir = DEFAULT_BIN_DIR; // directory containing the task executables
+};
+
+
+/** A single run of a day's executable, either on its own input.txt or on a generated input (see generate)
+ */
+struct Task {
+  int number;
+  std::string inputPath; // absolute, empty for the day's own input
+};
+
+
+struct TaskOutput {
+  std::string output;
+  bool timedOut = false;
+  registry::StructuredOutput result; // parsed from output
+};
+
+
+std::string taskName(int taskNumber) {
+  std::ostringstream name;
+  name << std::setfill('0') << std::setw(2) << taskNumber;
+  return name.str();
+}
+
 
-std::string getTaskOutput(int taskNumber) {
+#ifdef _WIN32
+
+// Creating the pipes and processes must be serialized, otherwise a task could inherit the write end of another task's pipe,
+// which would keep that pipe open until both tasks are finished
+std::mutex spawnMtx;
+
+TaskOutput getTaskOutput(const Task& task, const Options& options) {
   SECURITY_ATTRIBUTES pipeSecurityAttributes = {
     .nLength = sizeof(SECURITY_ATTRIBUTES),
     .bInheritHandle = TRUE
   };
   HANDLE readPipe, writePipe;
-  BOOL success = CreatePipe(
-    &readPipe, // hReadPipe
-    &writePipe, // hWritePipe
-    &pipeSecurityAttributes, // lpPipeAttributes
-    0); // nSize (0 means default)
-  assert(success);
+  PROCESS_INFORMATION processInfo = {};
 
-  std::string output;
+  std::string taskId = taskName(task.number);
+  auto exePath = options.binDir + taskId + ".exe";
+  auto workDir = "..\\" + taskId + "\\";
+
+  TaskOutput result;
+  {
+    std::unique_lock<std::mutex> lock(spawnMtx);
+    BOOL success = CreatePipe(
+      &readPipe, // hReadPipe
+      &writePipe, // hWritePipe
+      &pipeSecurityAttributes, // lpPipeAttributes
+      0); // nSize (0 means default)
+    if (!success) {
+      result.output = "Failed to create the output pipe for " + exePath;
+      return result;
+    }
+
+    // Only the write end must be inherited by the task
+    SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startupInfo = {
+        .cb = sizeof(STARTUPINFOA),
+        .dwFlags = STARTF_USESTDHANDLES,
+        .hStdInput = INVALID_HANDLE_VALUE,
+        .hStdOutput = writePipe,
+        .hStdError = writePipe
+    };
 
-  auto readingThreadFunc = [readPipe, &output]() {
+    std::string commandLine = "\"" + exePath + "\" " + std::string(registry::STRUCTURED_OUTPUT_ARG);
+    if (!task.inputPath.empty()) {
+      commandLine += " " + std::string(registry::INPUT_ARG) + " \"" + task.inputPath + "\"";
+    }
+    success = CreateProcessA(
+      exePath.c_str(), // lpApplicationName
+      commandLine.data(), // lpCommandLine
+      NULL, // lpProcessAttributes
+      NULL, // lpThreadAttributes
+      TRUE, // bInheritHandles
+      0, // dwCreationFlags
+      NULL, // lpEnvironment
+      workDir.c_str(), // lpCurrentDirectory
+      &startupInfo,
+      &processInfo);
+
+    // The task has its own copy of the write end now, closing ours lets ReadFile() fail once the task exits
+    CloseHandle(writePipe);
+    if (!success) {
+      CloseHandle(readPipe);
+      result.output = "Failed to start " + exePath;
+      return result;
+    }
+  }
+
+  auto readingThreadFunc = [readPipe, &result]() {
     char buf[256];
     for (;;) {
       DWORD bytesRead;
       BOOL ok = ReadFile(readPipe, buf, sizeof(buf), &bytesRead, NULL);
       if (ok) {
-        output.append(buf, bytesRead);
+        result.output.append(buf, bytesRead);
       } else {
         return;
       }
@@ -50,62 +165,207 @@ std::string getTaskOutput(int taskNumber) {
   };
   std::thread readingThread{ readingThreadFunc };
 
-  STARTUPINFOA startupInfo = {
-      .cb = sizeof(STARTUPINFOA),
-      .dwFlags = STARTF_USESTDHANDLES,
-      .hStdInput = INVALID_HANDLE_VALUE,
-      .hStdOutput = writePipe,
-      .hStdError = writePipe
-  };
-  PROCESS_INFORMATION processInfo = {};
-
-  std::string taskId = std::format("{:02d}", taskNumber);
-  auto exePath = "..\\x64\\" CONFIG "\\" + taskId + ".exe";
-  auto workDir = "..\\" + taskId + "\\";
-
-  success = CreateProcessA(
-    exePath.c_str(), // lpApplicationName
-    NULL, // lpCommandLine
-    NULL, // lpProcessAttributes
-    NULL, // lpThreadAttributes
-    TRUE, // bInheritHandles
-    0, // dwCreationFlags
-    NULL, // lpEnvironment
-    workDir.c_str(), // lpCurrentDirectory
-    &startupInfo,
-    &processInfo);
-  assert(success);
-
-  WaitForSingleObject(processInfo.hProcess, INFINITE);
+  // INFINITE is the largest DWORD, so longer timeouts are capped just below it
+  auto timeoutMs = static_cast<DWORD>(std::min<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(options.timeout).count(), INFINITE - 1));
+  if (WaitForSingleObject(processInfo.hProcess, timeoutMs) == WAIT_TIMEOUT) {
+    TerminateProcess(processInfo.hProcess, 1);
+    WaitForSingleObject(processInfo.hProcess, INFINITE);
+    result.timedOut = true;
+  }
   CloseHandle(processInfo.hThread);
   CloseHandle(processInfo.hProcess);
 
-  CloseHandle(writePipe);
+  readingThread.join();
   CloseHandle(readPipe);
 
-  readingThread.join();
+  return result;
+}
+
+
+/** Runs the given tasks with at most options.jobs tasks at the same time and returns their outputs (in the same order)
+ */
+std::vector<TaskOutput> runTasks(const std::vector<Task>& tasks, const Options& options) {
+  std::vector<TaskOutput> outputs(tasks.size());
+  std::atomic<size_t> nextTask = 0;
+
+  auto worker = [&]() {
+    for (size_t i; (i = nextTask++) < tasks.size();) {
+      outputs[i] = getTaskOutput(tasks[i], options);
+    }
+  };
 
-  return output;
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned i = 0; i < options.jobs; ++i) {
+      workers.emplace_back(worker);
+    }
+  } // join all workers
+
+  return outputs;
+}
+
+#else
+
+/** A task started by runTasks(), which is still running or whose output has not been fully read yet
+ */
+struct RunningTask {
+  size_t index; // into the task list
+  pid_t pid;
+  int outputFd; // -1 after reading EOF
+  std::chrono::steady_clock::time_point deadline;
+  TaskOutput result;
+};
+
+
+/** Starts the task with stdout and stderr redirected into a new pipe
+ */
+RunningTask spawnTask(size_t index, const Task& taskToRun, const Options& options) {
+  std::string taskId = taskName(taskToRun.number);
+  auto exePath = options.binDir + taskId;
+  auto workDir = "../" + taskId + "/";
+
+  int pipeFds[2];
+  int ok = pipe(pipeFds);
+  assert(ok == 0);
+  // Don't leak the pipes into other tasks (dup2 clears the flag for the task's own stdout/stderr)
+  fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+  posix_spawn_file_actions_addchdir_np(&actions, workDir.c_str());
+
+  // With the changed working directory the executable path must not be relative anymore
+  char* resolvedPath = realpath(exePath.c_str(), nullptr);
+  std::string absolutePath = resolvedPath ? resolvedPath : exePath;
+  free(resolvedPath);
+
+  // Start the task in its own process group to be able to kill it together with all its children on timeout
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+  posix_spawnattr_setpgroup(&attributes, 0);
+
+  std::string structuredOutputArg(registry::STRUCTURED_OUTPUT_ARG);
+  std::string inputArg(registry::INPUT_ARG);
+  std::string inputPath = taskToRun.inputPath;
+  std::vector<char*> argv = { absolutePath.data(), structuredOutputArg.data() };
+  if (!inputPath.empty()) {
+    argv.push_back(inputArg.data());
+    argv.push_back(inputPath.data());
+  }
+  argv.push_back(nullptr);
+  pid_t pid = -1;
+  if (posix_spawn(&pid, absolutePath.c_str(), &actions, &attributes, argv.data(), environ) != 0) {
+    pid = -1;
+  }
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+  close(pipeFds[1]); // the task has its own copy now
+
+  RunningTask task = { index, pid, pipeFds[0], std::chrono::steady_clock::now() + options.timeout };
+  if (pid == -1) {
+    task.result.output = "Failed to start " + absolutePath;
+    close(task.outputFd);
+    task.outputFd = -1;
+  }
+  return task;
 }
 
-std::regex part1Regex("(Part|Result) ?1: ?(.*)");
-std::regex part2Regex("(Part|Result) ?2: ?(.*)");
 
+/** Runs the given tasks with at most options.jobs tasks at the same time and returns their outputs (in the same order)
+ *  The outputs of all running tasks are read in a single poll() loop. Tasks running longer than options.timeout are killed.
+ */
+std::vector<TaskOutput> runTasks(const std::vector<Task>& tasks, const Options& options) {
+  std::vector<TaskOutput> outputs(tasks.size());
+  std::vector<RunningTask> running;
+  size_t nextTask = 0;
+
+  while (nextTask < tasks.size() || !running.empty()) {
+    while (running.size() < options.jobs && nextTask < tasks.size()) {
+      running.push_back(spawnTask(nextTask, tasks[nextTask], options));
+      ++nextTask;
+    }
+
+    // Wait for output, but not past the next deadline. Tasks, which closed their output are reaped every 10ms.
+    auto now = std::chrono::steady_clock::now();
+    std::vector<pollfd> pollFds;
+    auto pollTimeout = std::chrono::milliseconds::max();
+    for (auto& task : running) {
+      if (task.outputFd != -1) {
+        pollFds.push_back({ .fd = task.outputFd, .events = POLLIN });
+      } else {
+        pollTimeout = std::min(pollTimeout, std::chrono::milliseconds(10));
+      }
+      if (!task.result.timedOut) {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(task.deadline - now);
+        pollTimeout = std::min(pollTimeout, std::max(remaining, std::chrono::milliseconds(0)));
+      }
+    }
+    poll(pollFds.data(), pollFds.size(), pollTimeout == std::chrono::milliseconds::max() ? -1 : static_cast<int>(pollTimeout.count()));
+
+    now = std::chrono::steady_clock::now();
+    for (auto& task : running) {
+      if (task.outputFd != -1) {
+        auto pollFd = std::find_if(pollFds.begin(), pollFds.end(), [&](const pollfd& fd) { return fd.fd == task.outputFd; });
+        if (pollFd->revents & (POLLIN | POLLHUP | POLLERR)) {
+          char buf[4096];
+          auto bytesRead = read(task.outputFd, buf, sizeof(buf));
+          if (bytesRead > 0) {
+            task.result.output.append(buf, bytesRead);
+          } else {
+            close(task.outputFd); // EOF
+            task.outputFd = -1;
+          }
+        }
+      }
+
+      if (!task.result.timedOut && task.pid != -1 && now >= task.deadline) {
+        kill(-task.pid, SIGKILL); // the whole process group
+        task.result.timedOut = true;
+        if (task.outputFd != -1) {
+          close(task.outputFd); // we don't care for the remaining output
+          task.outputFd = -1;
+        }
+      }
+    }
+
+    // Reap all tasks, which have exited and closed their output
+    std::erase_if(running, [&](RunningTask& task) {
+      if (task.outputFd != -1) {
+        return false;
+      }
+      if (task.pid != -1) {
+        int status;
+        if (waitpid(task.pid, &status, WNOHANG) == 0) {
+          return false; // still running
+        }
+      }
+      outputs[task.index] = std::move(task.result);
+      return true;
+    });
+  }
+
+  return outputs;
+}
 
-bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::string>>& expected, const std::string& output) {
-  std::smatch match;
+#endif
+
+
+bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::string>>& expected, const TaskOutput& output) {
   bool okay = true;
-  if (!std::regex_search(output, match, part1Regex)) {
-    std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Failed to recognize part1 output in: \"" << output << "\"\n";
+  if (!output.result.part1) {
+    std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Failed to recognize part1 output in: \"" << output.output << "\"\n";
     okay = false;
   }
 
-  auto actualFirst = match[2].str();
-  if (expected.second && !std::regex_search(output, match, part2Regex)) {
-    std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Failed to recognize part2 output in: \"" << output << "\"\n";
+  if (expected.second && !output.result.part2) {
+    std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Failed to recognize part2 output in: \"" << output.output << "\"\n";
     okay = false;
   }
-  auto actualSecond = match[2].str();
 
   if (!okay) {
     return false; // don't compare results if parsing of output failed
@@ -113,6 +373,7 @@ bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::str
 
 
 
+  auto& actualFirst = *output.result.part1;
   if (actualFirst != expected.first) {
     std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Wrong result in Part 1:\n"
       << "  expected: \"" << expected.first << "\"\n"
@@ -120,10 +381,10 @@ bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::str
     okay = false;
   }
 
-  if (expected.second && *expected.second != actualSecond) {
+  if (expected.second && *expected.second != *output.result.part2) {
     std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Wrong result in Part 2:\n"
       << "  expected: \"" << *expected.second << "\"\n"
-      << "  actual:   \"" << actualSecond << "\"\n";
+      << "  actual:   \"" << *output.result.part2 << "\"\n";
     okay = false;
   }
 
@@ -135,40 +396,298 @@ bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::str
 }
 
 
+/** Prints the phase timings and peak memory reported by all finished tasks. The allocation columns are only shown,
+ *  if the tasks were built with AOC_COUNT_ALLOCATIONS.
+ */
+void printPerformance(const std::vector<Task>& tasks, const std::vector<TaskOutput>& outputs) {
+  bool allocations = std::ranges::any_of(outputs, [](const TaskOutput& output) { return output.result.solveAllocations.has_value(); });
+  auto optional = [](const std::optional<int64_t>& value, int64_t divisor = 1) {
+    return value ? std::to_string(*value / divisor) : std::string("-");
+  };
+
+  std::cout << "\nDay    Parse [ms]    Solve [ms]    Peak memory [KiB]";
+  if (allocations) {
+    std::cout << "    Parse allocs    Solve allocs    Allocated [KiB]    Peak heap [KiB]";
+  }
+  std::cout << "\n";
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    auto& output = outputs[i];
+    auto& result = output.result;
+    std::cout << std::setfill('0') << std::setw(2) << tasks[i].number << std::setfill(' ');
+    if (output.timedOut || !result.part1) {
+      std::cout << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(21) << "-" << "\n";
+      continue;
+    }
+    std::cout << std::fixed << std::setprecision(3)
+      << std::setw(14) << result.parseNs / 1e6
+      << std::setw(14) << result.solveNs / 1e6
+      << std::setw(21) << result.peakMemoryKiB << std::defaultfloat;
+    if (allocations) {
+      std::cout << std::setw(16) << optional(result.parseAllocations)
+        << std::setw(16) << optional(result.solveAllocations)
+        << std::setw(19) << optional(result.allocatedBytes, 1024)
+        << std::setw(19) << optional(result.peakHeapBytes, 1024);
+    }
+    std::cout << "\n";
+  }
+}
+
+
+/** A generated input DIR/NN/x<scale>.txt together with the answers from DIR/NN/x<scale>.expected */
+struct ScalingInput {
+  int day;
+  int scale;
+  std::filesystem::path path;
+  uintmax_t size; // in bytes
+  results::Expected expected;
+};
+
+
+/** All generated inputs in the given directory, ordered by day and scale */
+std::vector<ScalingInput> findScalingInputs(const std::filesystem::path& dir) {
+  std::vector<ScalingInput> inputs;
+  for (int day = 1; day <= 25; ++day) {
+    auto dayDir = dir / taskName(day);
+    if (!std::filesystem::is_directory(dayDir)) {
+      continue;
+    }
+    for (auto& entry : std::filesystem::directory_iterator(dayDir)) {
+      auto name = entry.path().filename().string();
+      if (!name.starts_with('x') || entry.path().extension() != ".txt") {
+        continue;
+      }
+      auto stem = entry.path().stem().string(); // "x<scale>"
+      int scale = 0;
+      auto [end, error] = std::from_chars(stem.data() + 1, stem.data() + stem.size(), scale);
+      if (error != std::errc() || end != stem.data() + stem.size()) {
+        continue; // not a generated input
+      }
+      ScalingInput input{ day, scale, std::filesystem::absolute(entry.path()), entry.file_size() };
+      std::ifstream expectedFile(std::filesystem::path(entry.path()).replace_extension(".expected"));
+      std::string line;
+      if (std::getline(expectedFile, line)) {
+        input.expected = results::parseLine(line);
+      }
+      inputs.push_back(std::move(input));
+    }
+  }
+  std::ranges::sort(inputs, {}, [](const ScalingInput& input) { return std::pair(input.day, input.scale); });
+  return inputs;
+}
+
+
+std::string scalingVerdict(const ScalingInput& input, const TaskOutput& output) {
+  if (output.timedOut) {
+    return "timeout";
+  }
+  if (!output.result.part1) {
+    return "no output";
+  }
+  if (!input.expected) {
+    return "unchecked";
+  }
+  bool okay = *output.result.part1 == input.expected->first
+    && (!input.expected->second || output.result.part2 == input.expected->second);
+  return okay ? "OK" : "WRONG";
+}
+
+
+/** Slope of the least squares line through the points (log x, log y), i.e. the k in y ~ x^k */
+std::optional<double> logLogSlope(const std::vector<std::pair<double, double>>& points) {
+  if (points.size() < 2) {
+    return std::nullopt;
+  }
+  double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+  for (auto [x, y] : points) {
+    auto logX = std::log(x);
+    auto logY = std::log(std::max(y, 1e-9));
+    sumX += logX;
+    sumY += logY;
+    sumXX += logX * logX;
+    sumXY += logX * logY;
+  }
+  auto n = static_cast<double>(points.size());
+  auto denominator = n * sumXX - sumX * sumX;
+  if (denominator <= 0) {
+    return std::nullopt;
+  }
+  return (n * sumXY - sumX * sumY) / denominator;
+}
+
+
+/** Runs every day on its generated inputs of increasing size (see generate), checks the answers and reports how time and
+ *  memory grow with the input size. The measurements are also written to DIR/scaling.csv for plotting.
+ *  Returns the number of wrong or failed runs.
+ */
+int runScaling(const std::filesystem::path& dir, const Options& options) {
+  auto inputs = findScalingInputs(dir);
+  if (inputs.empty()) {
+    std::cout << "No generated inputs found in " << dir.string() << "\n";
+    return 1;
+  }
+
+  std::vector<Task> tasks;
+  for (auto& input : inputs) {
+    tasks.push_back({ input.day, input.path.string() });
+  }
+  auto outputs = runTasks(tasks, options);
+  for (auto& output : outputs) {
+    output.result = registry::StructuredOutput::parse(output.output);
+  }
+
+  int wrongRuns = 0;
+  std::ofstream csv(dir / "scaling.csv");
+  csv << "day,scale,input_bytes,parse_ns,solve_ns,peak_memory_kib,verdict\n";
+  std::cout << "Day     Scale    Input [KiB]    Parse [ms]    Solve [ms]    Peak memory [KiB]    Verdict\n";
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto& input = inputs[i];
+    auto& result = outputs[i].result;
+    auto verdict = scalingVerdict(input, outputs[i]);
+    wrongRuns += verdict != "OK" && verdict != "unchecked";
+
+    csv << input.day << "," << input.scale << "," << input.size << "," << result.parseNs << "," << result.solveNs << ","
+      << result.peakMemoryKiB << "," << verdict << "\n";
+    std::cout << std::setfill('0') << std::setw(2) << input.day << std::setfill(' ')
+      << std::setw(10) << input.scale
+      << std::setw(15) << (input.size + 1023) / 1024
+      << std::fixed << std::setprecision(3)
+      << std::setw(14) << result.parseNs / 1e6
+      << std::setw(14) << result.solveNs / 1e6
+      << std::setw(21) << result.peakMemoryKiB
+      << "    " << verdict << "\n" << std::defaultfloat;
+  }
+
+  // Per day: total time on a log scale (one '#' per doubling above 1us) and the estimated exponents k in time ~ size^k
+  std::cout << "\nDay     Scale    Total time (log2 us)\n";
+  for (size_t first = 0; first < inputs.size();) {
+    auto last = first;
+    std::vector<std::pair<double, double>> timePoints, memoryPoints;
+    for (; last < inputs.size() && inputs[last].day == inputs[first].day; ++last) {
+      auto& result = outputs[last].result;
+      if (!result.part1) {
+        continue;
+      }
+      auto totalNs = static_cast<double>(result.parseNs + result.solveNs);
+      auto size = static_cast<double>(std::max<uintmax_t>(inputs[last].size, 1));
+      timePoints.emplace_back(size, totalNs);
+      memoryPoints.emplace_back(size, static_cast<double>(result.peakMemoryKiB));
+      auto bar = static_cast<int>(std::max(0.0, std::log2(totalNs / 1e3))) + 1;
+      std::cout << std::setfill('0') << std::setw(2) << inputs[last].day << std::setfill(' ')
+        << std::setw(10) << inputs[last].scale << "    " << std::string(bar, '#') << "\n";
+    }
+
+    auto formatSlope = [](std::optional<double> slope) {
+      if (!slope) {
+        return std::string("-");
+      }
+      std::ostringstream text;
+      text << std::fixed << std::setprecision(2) << *slope;
+      return text.str();
+    };
+    std::cout << std::setfill('0') << std::setw(2) << inputs[first].day << std::setfill(' ')
+      << "      time ~ size^" << formatSlope(logLogSlope(timePoints))
+      << ", memory ~ size^" << formatSlope(logLogSlope(memoryPoints)) << "\n";
+    first = last;
+  }
+
+  return wrongRuns;
+}
+
+
+
+/** Parses the value of a numeric option, returns std::nullopt if it isn't a number >= 1
+ */
+std::optional<unsigned> parsePositive(std::string_view value) {
+  unsigned number = 0;
+  auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+  if (error != std::errc() || end != value.data() + value.size() || number == 0) {
+    return std::nullopt;
+  }
+  return number;
+}
+
 
 
 // This project will check the results of all exercises (to validate correct it works correct after refactorings)
-int main() {
-  for (auto line : stream::lines(std::ifstream("..\\data\\results.txt"))) {
-    std::smatch match;
-    std::regex_match(line, match, resultsRegex);
-    if (match[1].matched) {
-      // commented out
-      results.push_back(std::nullopt);
-    } else {
-      std::pair<std::string, std::optional<std::string>> result;
-      result.first = match[3].matched ? match[3].str() : match[4].str();
-      if (match[5].matched) {
-        result.second = match[7].matched ? match[7].str() : match[8].str();
+// The tasks are started with --structured and report their results, phase timings and peak memory in the form
+// described at registry::StructuredOutput, which are printed as performance table after the verdicts.
+// Options:
+//   --jobs N         run up to N tasks at the same time (default: number of cores)
+//   --timeout S      kill tasks running longer than S seconds (default: 60)
+//   --bin-dir DIR    directory containing the task executables
+//   --scaling DIR    instead of checking the real inputs, run all inputs created by generate in DIR (see runScaling)
+int main(int argc, char* argv[]) {
+  Options options;
+  std::optional<std::filesystem::path> scalingDir;
+  for (int i = 1; i < argc; i += 2) {
+    std::string_view option = argv[i];
+    bool known = option == "--jobs" || option == "--timeout" || option == "--bin-dir" || option == "--scaling";
+    if (known && i + 1 == argc) {
+      std::cout << "Missing value for option: " << option << "\n";
+      return 1;
+    }
+
+    if (option == "--jobs" || option == "--timeout") {
+      auto value = parsePositive(argv[i + 1]);
+      if (!value) {
+        std::cout << "Invalid value for option " << option << ": \"" << argv[i + 1] << "\" (expected a whole number >= 1)\n";
+        return 1;
       }
-      results.push_back(result);
+      if (option == "--jobs") {
+        options.jobs = *value;
+      } else {
+        options.timeout = std::chrono::seconds(*value);
+      }
+    } else if (option == "--bin-dir") {
+      options.binDir = argv[i + 1];
+    } else if (option == "--scaling") {
+      scalingDir = argv[i + 1];
+    } else {
+      std::cout << "Unknown option: " << option << "\n";
+      return 1;
     }
   }
 
+  if (scalingDir) {
+    int wrongRuns = runScaling(*scalingDir, options);
+    std::cout << "\n\n" << wrongRuns << " Errors!";
+    return wrongRuns == 0 ? 0 : 1;
+  }
+
+  expectedResults = results::load(std::ifstream(RESULTS_PATH));
+
+  // Run all tasks, which are not commented out, concurrently
+  std::vector<Task> tasks;
+  for (int taskNr = 1; taskNr <= expectedResults.size(); ++taskNr) {
+    if (expectedResults[taskNr - 1]) {
+      tasks.push_back({ taskNr, "" });
+    }
+  }
+  auto outputs = runTasks(tasks, options);
+  for (auto& output : outputs) {
+    output.result = registry::StructuredOutput::parse(output.output);
+  }
+
 
   int wrongTasks = 0;
   int taskNr = 0;
-  for (auto& expected : results) {
+  auto output = outputs.begin();
+  for (auto& expected : expectedResults) {
     ++taskNr;
     if (expected) { // don't run commented out tasks
-      auto output = getTaskOutput(taskNr);
-      if (!checkResult(taskNr, *expected, output)) {
+      if (output->timedOut) {
+        std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Timeout after " << options.timeout.count() << "s\n";
+        ++wrongTasks;
+      } else if (!checkResult(taskNr, *expected, *output)) {
         ++wrongTasks;
       }
+      ++output;
     } else {
       std::cout << std::setfill('0') << std::setw(2) << taskNr << ": skipped\n";
     }
   }
 
+  printPerformance(tasks, outputs);
+
   std::cout << "\n\n" << wrongTasks << " Errors!";
 }
@@ -0,0 +1,883 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <filesystem>
+#include <functional>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <iomanip>
+#include <optional>
+#include <tuple>
+#include <bit>
+
+/** Generates seeded, deterministic synthetic inputs for all days at multiple scales (1x = roughly the size of the real
+ *  puzzle input). Next to each input the expected results are written, which are calculated by a reference path, that
+ *  is independent of the actual solution (brute force where feasible, otherwise a different algorithm or known by construction).
+ *
+ *  Usage: generate [--seed N] [--out DIR] [--scales 1,10,100,1000] [DAY...]
+ *
+ *  Writes DIR/XX/x<scale>.txt and DIR/XX/x<scale>.expected (same format as data/results.txt). The generated inputs
+ *  can be checked and measured with `check_all --scaling DIR`.
+ */
+
+#ifdef _WIN32
+#define DEFAULT_OUT_DIR "..\\data\\generated\\"
+#else
+#define DEFAULT_OUT_DIR "../data/generated/"
+#endif
+
+
+using Rng = std::mt19937_64;
+using Answers = std::pair<int64_t, int64_t>;
+
+/** Uniformly distributed number in [min, max] */
+int64_t uniform(Rng& rng, int64_t min, int64_t max) {
+  return std::uniform_int_distribution<int64_t>(min, max)(rng);
+}
+
+int digitCount(int64_t number) {
+  int digits = 1;
+  for (; number >= 10; number /= 10) {
+    ++digits;
+  }
+  return digits;
+}
+
+int64_t power10(int exponent) {
+  int64_t result = 1;
+  for (; exponent > 0; --exponent) {
+    result *= 10;
+  }
+  return result;
+}
+
+
+
+namespace day01 {
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  int dial = 50;
+  for (int i = 0; i < 1000 * scale; ++i) {
+    bool right = uniform(rng, 0, 1);
+    auto distance = uniform(rng, 1, 999);
+    out << (right ? 'R' : 'L') << distance << "\n";
+
+    // Reference: simulate every single click
+    for (int click = 0; click < distance; ++click) {
+      dial = (dial + (right ? 1 : 99)) % 100;
+      part2 += dial == 0;
+    }
+    part1 += dial == 0;
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day02 {
+
+/** Checks whether the number consists of exactly `parts` repetitions of the same digit sequence */
+bool isRepetition(int64_t number, int parts) {
+  auto digits = digitCount(number);
+  if (digits % parts != 0) {
+    return false;
+  }
+  auto divisor = power10(digits / parts);
+  auto prefix = number % divisor;
+  for (; number > 0; number /= divisor) {
+    if (number % divisor != prefix) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  for (int i = 0; i < 10 * scale; ++i) {
+    // Place each range around a repeated number, otherwise almost all ranges would be without any invalid id
+    auto prefixDigits = static_cast<int>(uniform(rng, 1, 5));
+    auto times = uniform(rng, 2, 10 / prefixDigits);
+    auto prefix = uniform(rng, power10(prefixDigits - 1), power10(prefixDigits) - 1);
+    int64_t center = 0;
+    for (int j = 0; j < times; ++j) {
+      center = center * power10(prefixDigits) + prefix;
+    }
+    auto begin = std::max<int64_t>(1, center - uniform(rng, 0, 5000));
+    auto end = center + uniform(rng, 0, 5000);
+    out << (i > 0 ? "," : "") << begin << "-" << end;
+
+    // Reference: check every single number in the range
+    for (auto number = begin; number <= end; ++number) {
+      if (isRepetition(number, 2)) {
+        part1 += number;
+      }
+      for (int parts = 2; parts <= digitCount(number); ++parts) {
+        if (isRepetition(number, parts)) {
+          part2 += number;
+          break;
+        }
+      }
+    }
+  }
+  out << "\n";
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day03 {
+
+/** Reference: dynamic programming over the best joltage with j batteries from the suffix of the ratings */
+int64_t maxJoltage(const std::string& ratings, int nBatteries) {
+  std::vector<int64_t> best(nBatteries + 1, -1);
+  best[0] = 0;
+  for (auto digit = ratings.rbegin(); digit != ratings.rend(); ++digit) {
+    for (int j = nBatteries; j >= 1; --j) {
+      if (best[j - 1] >= 0) {
+        best[j] = std::max(best[j], (*digit - '0') * power10(j - 1) + best[j - 1]);
+      }
+    }
+  }
+  return best[nBatteries];
+}
+
+/** The lines vary in length and every line has its own highest digit, which only occurs up to twice at random positions.
+ *  Uniform digits over 100 positions would almost always contain two 9s and make every Part 1 result 99.
+ */
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  for (int i = 0; i < 200 * scale; ++i) {
+    std::string ratings(uniform(rng, 12, 100), '0');
+    auto highest = uniform(rng, 2, 9);
+    for (auto& rating : ratings) {
+      rating = static_cast<char>('0' + uniform(rng, 1, highest - 1));
+    }
+    for (auto count = uniform(rng, 0, 2); count > 0; --count) {
+      ratings[uniform(rng, 0, ratings.size() - 1)] = static_cast<char>('0' + highest);
+    }
+    out << ratings << "\n";
+    part1 += maxJoltage(ratings, 2);
+    part2 += maxJoltage(ratings, 12);
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day04 {
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  int size = static_cast<int>(std::lround(140 * std::sqrt(scale)));
+  std::vector<std::string> grid(size, std::string(size, '.'));
+  for (auto& row : grid) {
+    for (auto& cell : row) {
+      cell = uniform(rng, 0, 99) < 65 ? '@' : '.';
+    }
+    out << row << "\n";
+  }
+
+  // Reference: count the neighbours once and remove accessible rolls through a work queue
+  auto isRoll = [&](int x, int y) { return x >= 0 && y >= 0 && x < size && y < size && grid[y][x] == '@'; };
+  std::vector<int> neighbours(size * size);
+  std::queue<std::pair<int, int>> accessible;
+  int64_t part1 = 0;
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      if (!isRoll(x, y)) {
+        continue;
+      }
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          neighbours[y * size + x] += (dx != 0 || dy != 0) && isRoll(x + dx, y + dy);
+        }
+      }
+      if (neighbours[y * size + x] < 4) {
+        ++part1;
+        accessible.emplace(x, y);
+      }
+    }
+  }
+
+  int64_t part2 = 0;
+  while (!accessible.empty()) {
+    auto [x, y] = accessible.front();
+    accessible.pop();
+    grid[y][x] = '.';
+    ++part2;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        // Only rolls, which just dropped below 4 neighbours are queued, the others are already queued or still blocked
+        if ((dx != 0 || dy != 0) && isRoll(x + dx, y + dy) && neighbours[(y + dy) * size + x + dx]-- == 4) {
+          accessible.emplace(x + dx, y + dy);
+        }
+      }
+    }
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day05 {
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  // The ranges get shorter as their number grows, so that roughly the same fraction of the ids stays covered
+  constexpr int64_t MAX_ID = 100'000'000'000'000;
+  std::vector<std::pair<int64_t, int64_t>> ranges; // [begin, end)
+  for (int i = 0; i < 200 * scale; ++i) {
+    auto begin = uniform(rng, 1, MAX_ID);
+    auto end = begin + uniform(rng, 0, MAX_ID / (200 * scale));
+    out << begin << "-" << end << "\n";
+    ranges.emplace_back(begin, end + 1);
+  }
+  out << "\n";
+
+  std::vector<int64_t> ids;
+  for (int i = 0; i < 1000 * scale; ++i) {
+    if (uniform(rng, 0, 1)) {
+      auto& range = ranges[uniform(rng, 0, ranges.size() - 1)];
+      ids.push_back(uniform(rng, range.first, range.second - 1));
+    } else {
+      ids.push_back(uniform(rng, 1, MAX_ID));
+    }
+    out << ids.back() << "\n";
+  }
+
+  // Reference: sweep over the sorted ranges and ids at the same time
+  std::ranges::sort(ranges);
+  std::ranges::sort(ids);
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  int64_t coveredUntil = 0;
+  for (auto& [begin, end] : ranges) {
+    part2 += std::max<int64_t>(0, end - std::max(begin, coveredUntil));
+    coveredUntil = std::max(coveredUntil, end);
+  }
+
+  std::priority_queue<int64_t, std::vector<int64_t>, std::greater<>> activeEnds;
+  auto range = ranges.begin();
+  for (auto id : ids) {
+    for (; range != ranges.end() && range->first <= id; ++range) {
+      activeEnds.push(range->second);
+    }
+    while (!activeEnds.empty() && activeEnds.top() <= id) {
+      activeEnds.pop();
+    }
+    part1 += !activeEnds.empty();
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day06 {
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  constexpr int ROWS = 4;
+  std::vector<std::string> lines(ROWS + 1);
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  for (int column = 0; column < 1000 * scale; ++column) {
+    auto width = static_cast<int>(uniform(rng, 1, 3));
+    bool multiply = uniform(rng, 0, 1);
+    bool leftAligned = uniform(rng, 0, 1);
+    auto widestRow = uniform(rng, 0, ROWS - 1);
+
+    std::vector<std::string> numbers;
+    int64_t result = multiply ? 1 : 0;
+    for (int row = 0; row < ROWS; ++row) {
+      auto digits = row == widestRow ? width : static_cast<int>(uniform(rng, 1, width));
+      auto number = uniform(rng, power10(digits - 1), power10(digits) - 1);
+      result = multiply ? result * number : result + number;
+
+      auto text = std::to_string(number);
+      auto padding = std::string(width - digits, ' ');
+      numbers.push_back(leftAligned ? text + padding : padding + text);
+    }
+    part1 += result;
+
+    // Part 2 reads the digits of each position from top to bottom
+    result = multiply ? 1 : 0;
+    for (int position = 0; position < width; ++position) {
+      int64_t number = 0;
+      for (auto& text : numbers) {
+        if (text[position] != ' ') {
+          number = number * 10 + (text[position] - '0');
+        }
+      }
+      result = multiply ? result * number : result + number;
+    }
+    part2 += result;
+
+    auto separator = column > 0 ? " " : "";
+    for (int row = 0; row < ROWS; ++row) {
+      lines[row] += separator + numbers[row];
+    }
+    lines[ROWS] += separator + std::string(1, multiply ? '*' : '+') + std::string(width - 1, ' ');
+  }
+
+  for (auto& line : lines) {
+    out << line << "\n";
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day07 {
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  // Splitters are on every second row, but never next to each other or at the border. The beams spread by at most one column
+  // per splitter row, so they never leave the field. The number of timelines is propagated while placing the splitters, and
+  // splitters that would push it beyond 60 bits are left out. Large fields therefore split densely at the top and carry many
+  // straight beams below.
+  constexpr uint64_t MAX_TIMELINES = uint64_t(1) << 60;
+  auto splitterRows = static_cast<int>(std::lround(70 * std::sqrt(scale)));
+  auto height = 2 * splitterRows + 2;
+  auto width = 2 * splitterRows + 3;
+  auto startX = width / 2;
+  std::bernoulli_distribution isSplitter(0.5);
+
+  std::vector<std::string> grid(height, std::string(width, '.'));
+  grid[0][startX] = 'S';
+
+  // Reference: propagate the number of timelines per column row by row
+  std::vector<uint64_t> timelines(width);
+  timelines[startX] = 1;
+  uint64_t totalTimelines = 1;
+  int64_t part1 = 0;
+  for (int y = 1; y < height; ++y) {
+    if (y % 2 == 0 && y / 2 <= splitterRows) {
+      for (int x = 1 + (startX + y / 2 + 1) % 2; x < width - 1; x += 2) {
+        if (isSplitter(rng) && totalTimelines + timelines[x] <= MAX_TIMELINES) {
+          grid[y][x] = '^';
+          totalTimelines += timelines[x];
+        }
+      }
+    }
+
+    std::vector<uint64_t> next(width);
+    for (int x = 0; x < width; ++x) {
+      if (timelines[x] == 0) {
+        continue;
+      }
+      if (grid[y][x] == '^') {
+        ++part1;
+        next[x - 1] += timelines[x];
+        next[x + 1] += timelines[x];
+      } else {
+        next[x] += timelines[x];
+      }
+    }
+    timelines = std::move(next);
+  }
+  for (auto& line : grid) {
+    out << line << "\n";
+  }
+
+  auto part2 = std::accumulate(timelines.begin(), timelines.end(), uint64_t(0));
+  assert(part2 == totalTimelines);
+  return { part1, static_cast<int64_t>(part2) };
+}
+
+}
+
+
+
+namespace day08 {
+
+struct Box {
+  int64_t x, y, z;
+};
+
+int64_t squaredDistance(const Box& a, const Box& b) {
+  return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z);
+}
+
+std::optional<Answers> tryGenerate(Rng& rng, int scale, std::ostream& out) {
+  constexpr int CONNECTIONS = 1000;
+  std::vector<Box> boxes(1000 * scale);
+  for (auto& box : boxes) {
+    box = { uniform(rng, 0, 99999), uniform(rng, 0, 99999), uniform(rng, 0, 99999) };
+  }
+  auto n = static_cast<int>(boxes.size());
+
+  // Reference Part 1: the shortest connections are collected in a bounded max heap (one more to detect a tie at the border)
+  // instead of sorting all pairs, then the circuits are formed with a union find
+  std::priority_queue<std::tuple<int64_t, int, int>> shortest;
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j) {
+      auto distance = squaredDistance(boxes[i], boxes[j]);
+      if (shortest.size() <= CONNECTIONS || distance < std::get<0>(shortest.top())) {
+        shortest.emplace(distance, i, j);
+        if (shortest.size() > CONNECTIONS + 1) {
+          shortest.pop();
+        }
+      }
+    }
+  }
+  auto borderDistance = std::get<0>(shortest.top());
+  shortest.pop();
+  if (std::get<0>(shortest.top()) == borderDistance) {
+    return std::nullopt; // the 1000 shortest connections are ambiguous
+  }
+
+  std::vector<int> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<int(int)> root = [&](int i) { return parent[i] == i ? i : parent[i] = root(parent[i]); };
+  for (; !shortest.empty(); shortest.pop()) {
+    auto [distance, i, j] = shortest.top();
+    parent[root(i)] = root(j);
+  }
+  std::vector<int64_t> circuitSizes(n);
+  for (int i = 0; i < n; ++i) {
+    ++circuitSizes[root(i)];
+  }
+  std::ranges::sort(circuitSizes, std::greater<>());
+  auto part1 = circuitSizes[0] * circuitSizes[1] * circuitSizes[2];
+
+  // Reference Part 2: the connection joining everything into one circuit is the longest edge of the minimum spanning tree (Prim)
+  std::vector<int64_t> distanceToTree(n, INT64_MAX);
+  std::vector<int> closestInTree(n, 0);
+  std::vector<bool> inTree(n, false);
+  distanceToTree[0] = 0;
+  std::tuple<int64_t, int, int> longestEdge = { -1, 0, 0 };
+  for (int step = 0; step < n; ++step) {
+    int next = -1;
+    for (int i = 0; i < n; ++i) {
+      if (!inTree[i] && (next == -1 || distanceToTree[i] < distanceToTree[next])) {
+        next = i;
+      }
+    }
+    inTree[next] = true;
+    if (step > 0) {
+      longestEdge = std::max(longestEdge, { distanceToTree[next], closestInTree[next], next });
+    }
+    for (int i = 0; i < n; ++i) {
+      auto distance = squaredDistance(boxes[next], boxes[i]);
+      if (!inTree[i] && distance < distanceToTree[i]) {
+        distanceToTree[i] = distance;
+        closestInTree[i] = next;
+      }
+    }
+  }
+  auto part2 = boxes[std::get<1>(longestEdge)].x * boxes[std::get<2>(longestEdge)].x;
+
+  for (auto& box : boxes) {
+    out << box.x << "," << box.y << "," << box.z << "\n";
+  }
+  return Answers{ part1, part2 };
+}
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  while (true) {
+    if (auto answers = tryGenerate(rng, scale, out)) {
+      return *answers;
+    }
+  }
+}
+
+}
+
+
+
+namespace day09 {
+
+/** Sparse table for O(1) range minimum queries */
+struct RangeMin {
+  RangeMin(std::vector<int64_t> values) : levels{ std::move(values) } {
+    for (size_t length = 2; length <= levels[0].size(); length *= 2) {
+      auto& previous = levels.back();
+      std::vector<int64_t> level(previous.size() - length / 2);
+      for (size_t i = 0; i < level.size(); ++i) {
+        level[i] = std::min(previous[i], previous[i + length / 2]);
+      }
+      levels.push_back(std::move(level));
+    }
+  }
+
+  /** Minimum of [begin, end] */
+  int64_t operator()(size_t begin, size_t end) const {
+    auto level = std::bit_width(end - begin + 1) - 1;
+    return std::min(levels[level][begin], levels[level][end + 1 - (size_t(1) << level)]);
+  }
+
+  std::vector<std::vector<int64_t>> levels;
+};
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  // A skyline polygon: for each column between xs[i] and xs[i+1] the polygon spans from bottoms[i] to tops[i].
+  // The columns are at least 2 wide, because like in the real inputs there are no directly adjacent parallel edges.
+  auto columns = 250 * scale;
+  std::vector<int64_t> xs(columns + 1);
+  std::vector<int64_t> tops(columns);
+  std::vector<int64_t> bottoms(columns);
+  xs[0] = uniform(rng, 1, 50);
+  for (int i = 1; i <= columns; ++i) {
+    xs[i] = xs[i - 1] + uniform(rng, 2, 98);
+  }
+  for (int i = 0; i < columns; ++i) {
+    do {
+      tops[i] = uniform(rng, columns * 20, columns * 40);
+    } while (i > 0 && tops[i] == tops[i - 1]);
+    do {
+      bottoms[i] = uniform(rng, 1, columns * 19);
+    } while (i > 0 && bottoms[i] == bottoms[i - 1]);
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> redTiles;
+  for (int i = 0; i < columns; ++i) {
+    redTiles.emplace_back(xs[i], tops[i]);
+    redTiles.emplace_back(xs[i + 1], tops[i]);
+  }
+  for (int i = columns - 1; i >= 0; --i) {
+    redTiles.emplace_back(xs[i + 1], bottoms[i]);
+    redTiles.emplace_back(xs[i], bottoms[i]);
+  }
+  for (auto [x, y] : redTiles) {
+    out << x << "," << y << "\n";
+  }
+
+  // Reference: The tiles inside the polygon at each x are an interval, which only changes at the vertex x coordinates.
+  // So the x axis is split into events (vertex columns and the space between them) and each rectangle is checked
+  // with a range query over the events it spans.
+  std::vector<int64_t> negatedLows;
+  std::vector<int64_t> highs;
+  std::vector<size_t> eventOfX(columns + 1);
+  for (int i = 0; i <= columns; ++i) {
+    auto left = std::max(i - 1, 0);
+    auto right = std::min(i, columns - 1);
+    eventOfX[i] = highs.size();
+    negatedLows.push_back(-std::min(bottoms[left], bottoms[right]));
+    highs.push_back(std::max(tops[left], tops[right]));
+    if (i < columns && xs[i + 1] - xs[i] >= 2) {
+      negatedLows.push_back(-bottoms[i]);
+      highs.push_back(tops[i]);
+    }
+  }
+  RangeMin minHigh(std::move(highs));
+  RangeMin minNegatedLow(std::move(negatedLows));
+
+  std::vector<size_t> tileEvent;
+  for (auto [x, y] : redTiles) {
+    tileEvent.push_back(eventOfX[std::ranges::lower_bound(xs, x) - xs.begin()]);
+  }
+
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  for (size_t a = 0; a < redTiles.size(); ++a) {
+    for (size_t b = a + 1; b < redTiles.size(); ++b) {
+      auto [xa, ya] = redTiles[a];
+      auto [xb, yb] = redTiles[b];
+      auto area = (std::abs(xa - xb) + 1) * (std::abs(ya - yb) + 1);
+      part1 = std::max(part1, area);
+      if (area > part2) {
+        auto [firstEvent, lastEvent] = std::minmax(tileEvent[a], tileEvent[b]);
+        if (-minNegatedLow(firstEvent, lastEvent) <= std::min(ya, yb) && minHigh(firstEvent, lastEvent) >= std::max(ya, yb)) {
+          part2 = area;
+        }
+      }
+    }
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+namespace day10 {
+
+/** Augmented matrix [A | joltages] of a machine after Gauss-Jordan elimination over the integers. Every pivot row has
+ *  a non-zero entry in its pivot column and zeros in all other pivot columns; the remaining rows are all zero.
+ */
+struct ReducedSystem {
+  std::vector<std::vector<int64_t>> rows;
+  std::vector<int> pivotColumns;
+  std::vector<int> freeColumns;
+};
+
+ReducedSystem reduce(const std::vector<std::vector<int>>& buttons, const std::vector<int64_t>& joltages) {
+  auto nButtons = static_cast<int>(buttons.size());
+  ReducedSystem system;
+  system.rows.assign(joltages.size(), std::vector<int64_t>(nButtons + 1, 0));
+  for (int b = 0; b < nButtons; ++b) {
+    for (auto c : buttons[b]) {
+      system.rows[c][b] = 1;
+    }
+  }
+  for (size_t c = 0; c < joltages.size(); ++c) {
+    system.rows[c][nButtons] = joltages[c];
+  }
+
+  auto& rows = system.rows;
+  size_t rank = 0;
+  for (int column = 0; column < nButtons; ++column) {
+    auto pivot = std::find_if(rows.begin() + rank, rows.end(), [&](auto& r) { return r[column] != 0; });
+    if (pivot == rows.end()) {
+      system.freeColumns.push_back(column);
+      continue;
+    }
+    std::swap(*pivot, rows[rank]);
+    for (size_t other = 0; other < rows.size(); ++other) {
+      if (other == rank || rows[other][column] == 0) {
+        continue;
+      }
+      // Cross multiplying keeps everything integral, dividing by the gcd of the row keeps the numbers small
+      auto factor = rows[other][column];
+      int64_t divisor = 0;
+      for (int c = 0; c <= nButtons; ++c) {
+        rows[other][c] = rows[other][c] * rows[rank][column] - rows[rank][c] * factor;
+        divisor = std::gcd(divisor, rows[other][c]);
+      }
+      if (divisor > 1) {
+        for (auto& value : rows[other]) {
+          value /= divisor;
+        }
+      }
+    }
+    system.pivotColumns.push_back(column);
+    ++rank;
+  }
+  return system;
+}
+
+/** Reference Part 2 of a machine: tries all values of the free variables (no button can be pressed more often than
+ *  the smallest joltage of its counters) and calculates the pivot variables from them, which must be non-negative integers.
+ */
+int64_t minJoltagePresses(const std::vector<std::vector<int>>& buttons, const std::vector<int64_t>& joltages) {
+  auto system = reduce(buttons, joltages);
+  auto nButtons = static_cast<int>(buttons.size());
+  std::vector<int64_t> bounds;
+  for (auto column : system.freeColumns) {
+    int64_t bound = INT64_MAX;
+    for (auto c : buttons[column]) {
+      bound = std::min(bound, joltages[c]);
+    }
+    bounds.push_back(bound);
+  }
+
+  int64_t best = INT64_MAX;
+  std::vector<int64_t> presses(system.freeColumns.size(), 0);
+  std::function<void(size_t, int64_t)> search = [&](size_t index, int64_t freePresses) {
+    if (freePresses >= best) {
+      return; // the pivot variables can only add presses
+    }
+    if (index < presses.size()) {
+      for (presses[index] = 0; presses[index] <= bounds[index]; ++presses[index]) {
+        search(index + 1, freePresses + presses[index]);
+      }
+      return;
+    }
+    auto total = freePresses;
+    for (size_t row = 0; row < system.pivotColumns.size(); ++row) {
+      auto& r = system.rows[row];
+      auto value = r[nButtons];
+      for (size_t f = 0; f < presses.size(); ++f) {
+        value -= r[system.freeColumns[f]] * presses[f];
+      }
+      auto coefficient = r[system.pivotColumns[row]];
+      if (value % coefficient != 0 || value / coefficient < 0) {
+        return;
+      }
+      total += value / coefficient;
+    }
+    best = std::min(best, total);
+  };
+  search(0, 0);
+  assert(best != INT64_MAX);
+  return best;
+}
+
+Answers generate(Rng& rng, int scale, std::ostream& out) {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+  for (int machine = 0; machine < 150 * scale; ++machine) {
+    // Machines with 0 to 4 free variables, i.e. more buttons than counters or linearly dependent buttons, where the
+    // presses used for generating the joltages are one solution for Part 2, but not necessarily the one with the fewest presses
+    auto nCounters = static_cast<int>(uniform(rng, 4, 10));
+    auto nFree = static_cast<int>(uniform(rng, 0, 4));
+    std::vector<std::vector<int>> buttons;
+    while (true) {
+      auto nButtons = static_cast<int>(uniform(rng, std::max(2, nFree + 1), std::min(13, nCounters + nFree)));
+      buttons.assign(nButtons, {});
+      std::vector<bool> covered(nCounters, false);
+      for (int b = 0; b < nButtons; ++b) {
+        for (int c = 0; c < nCounters; ++c) {
+          if (uniform(rng, 0, 2) == 0) {
+            buttons[b].push_back(c);
+          }
+        }
+        if (buttons[b].empty()) {
+          buttons[b].push_back(static_cast<int>(uniform(rng, 0, nCounters - 1)));
+        }
+        for (auto c : buttons[b]) {
+          covered[c] = true;
+        }
+      }
+      // Every counter must be affected by some button
+      if (std::ranges::find(covered, false) == covered.end()
+          && reduce(buttons, std::vector<int64_t>(nCounters, 0)).freeColumns.size() == static_cast<size_t>(nFree)) {
+        break;
+      }
+    }
+
+    std::vector<int64_t> joltages(nCounters, 0);
+    uint32_t lights = 0;
+    for (auto& button : buttons) {
+      auto presses = uniform(rng, 0, 20);
+      for (auto c : button) {
+        joltages[c] += presses;
+      }
+    }
+    while (lights == 0) { // an independent choice of buttons for the indicator lights, which must not all be off
+      lights = 0;
+      for (auto& button : buttons) {
+        if (uniform(rng, 0, 1)) {
+          for (auto c : button) {
+            lights ^= 1u << c;
+          }
+        }
+      }
+    }
+
+    // Reference Part 1: try all combinations of buttons
+    auto nButtons = static_cast<int>(buttons.size());
+    int minPresses = INT32_MAX;
+    for (uint32_t pressed = 0; pressed < (1u << nButtons); ++pressed) {
+      uint32_t result = 0;
+      for (int b = 0; b < nButtons; ++b) {
+        if (pressed & (1u << b)) {
+          for (auto c : buttons[b]) {
+            result ^= 1u << c;
+          }
+        }
+      }
+      if (result == lights) {
+        minPresses = std::min(minPresses, std::popcount(pressed));
+      }
+    }
+    part1 += minPresses;
+    part2 += minJoltagePresses(buttons, joltages);
+
+    out << "[";
+    for (int c = 0; c < nCounters; ++c) {
+      out << ((lights & (1u << c)) ? '#' : '.');
+    }
+    out << "]";
+    for (auto& button : buttons) {
+      out << " (";
+      for (size_t i = 0; i < button.size(); ++i) {
+        out << (i > 0 ? "," : "") << button[i];
+      }
+      out << ")";
+    }
+    out << " {";
+    for (int c = 0; c < nCounters; ++c) {
+      out << (c > 0 ? "," : "") << joltages[c];
+    }
+    out << "}\n";
+  }
+  return { part1, part2 };
+}
+
+}
+
+
+
+struct Generator {
+  Answers (*generate)(Rng& rng, int scale, std::ostream& out);
+  int maxScale; // larger scales are skipped, because the (quadratic) reference path would take too long
+};
+
+const std::vector<Generator> generators = {
+  { day01::generate, 1000 },
+  { day02::generate, 1000 },
+  { day03::generate, 1000 },
+  { day04::generate, 1000 },
+  { day05::generate, 1000 },
+  { day06::generate, 1000 },
+  { day07::generate, 1000 },
+  { day08::generate, 10 },
+  { day09::generate, 10 },
+  { day10::generate, 100 },
+};
+
+
+int main(int argc, char* argv[]) {
+  uint64_t seed = 2025;
+  std::filesystem::path outDir = DEFAULT_OUT_DIR;
+  std::vector<int> scales = { 1, 10, 100, 1000 };
+  std::vector<int> days;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--seed" && i + 1 < argc) {
+      seed = std::stoull(argv[++i]);
+    } else if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (arg == "--scales" && i + 1 < argc) {
+      scales.clear();
+      std::stringstream list(argv[++i]);
+      for (std::string scale; std::getline(list, scale, ',');) {
+        scales.push_back(std::stoi(scale));
+      }
+    } else {
+      auto day = std::atoi(argv[i]);
+      if (day < 1 || static_cast<size_t>(day) > generators.size()) {
+        std::cout << "Unknown option or day: " << arg << "\n";
+        return 1;
+      }
+      days.push_back(day);
+    }
+  }
+  if (days.empty()) {
+    days.resize(generators.size());
+    std::iota(days.begin(), days.end(), 1);
+  }
+
+  for (auto day : days) {
+    auto& generator = generators[day - 1];
+    std::stringstream dayName;
+    dayName << std::setfill('0') << std::setw(2) << day;
+    auto dayDir = outDir / dayName.str();
+    std::filesystem::create_directories(dayDir);
+
+    for (auto scale : scales) {
+      if (scale > generator.maxScale) {
+        std::cout << dayName.str() << " x" << scale << ": skipped (reference path too slow)\n";
+        continue;
+      }
+
+      // Seeded per day and scale, so the inputs don't depend on which days or scales are generated
+      Rng rng(seed * 1'000'003 + day * 10'007 + scale);
+      std::ofstream input(dayDir / ("x" + std::to_string(scale) + ".txt"), std::ios::binary);
+      auto [part1, part2] = generator.generate(rng, scale, input);
+      std::ofstream(dayDir / ("x" + std::to_string(scale) + ".expected"), std::ios::binary) << part1 << "," << part2 << "\n";
+      std::cout << dayName.str() << " x" << scale << ": " << part1 << "," << part2 << "\n";
+    }
+  }
+}
@@ -0,0 +1,379 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <map>
+
+#include <common/stream.hpp>
+#include <shared/registry.hpp>
+#include <shared/results.hpp>
+
+/** Runs any subset of the days in-process via the solver registry. In contrast to check_all no processes are spawned
+ *  and the input is read before the clock starts, so the measured time is the pure solving time of each day.
+ *
+ *  Usage: run_all [--parallel] [--threads N] [--bench [BENCHMARK OPTIONS]] [DAY...]
+ *
+ *  --threads N limits the shared thread pool of the parallel days to N threads (default: one per hardware thread).
+ *
+ *  Benchmark options:
+ *    --warmup N        untimed iterations before measuring (default 3)
+ *    --precision P     repeat until the 95% confidence interval of the mean is within +-P (relative, default 0.02)
+ *    --max-time S      upper limit of the measuring time per day in seconds (default 10)
+ *    --json FILE       write the benchmark results as JSON
+ *    --baseline FILE   compare against benchmark results written by an earlier run with --json
+ *    --threshold P     relative slowdown of a median against the baseline, which counts as regression (default 0.1)
+ *    --noise-floor US  phases, whose medians are both below this time in microseconds, never count as regression,
+ *                      because timer noise alone exceeds the threshold for them (default 50)
+ */
+
+#ifdef _WIN32
+#define DATA_PATH "..\\data\\"
+#define PATH_SEPARATOR "\\"
+#else
+#define DATA_PATH "../data/"
+#define PATH_SEPARATOR "/"
+#endif
+
+// The days are compiled with AOC_SOLVER_ONLY, so the allocation counting (if enabled) is hooked in here
+ALLOCATION_HOOKS()
+
+
+struct Options {
+  bool parallel = false;
+  bool benchmark = false;
+  int warmup = 3;
+  double precision = 0.02;
+  int minIterations = 10;
+  int maxIterations = 100000;
+  std::chrono::seconds maxTime{ 10 };
+  std::string jsonPath;
+  std::string baselinePath;
+  double threshold = 0.1;
+  std::chrono::nanoseconds noiseFloor = std::chrono::microseconds(50);
+};
+
+
+struct DayRun {
+  int day = 0;
+  std::string input;
+  std::optional<registry::Result> result;
+  std::string error;
+  std::chrono::nanoseconds time{};
+  std::chrono::nanoseconds parseTime{}; // part of time until the solver called registry::parsed()
+  alloc::Stats allocations; // only counted with AOC_COUNT_ALLOCATIONS, includes other days running in parallel
+
+  void run() {
+    registry::parseEnd.reset();
+    alloc::resetPeak();
+    auto startAllocations = alloc::snapshot();
+    auto start = std::chrono::steady_clock::now();
+    try {
+      result = registry::solvers().at(day)(input);
+    } catch (const std::exception& e) {
+      result.reset();
+      error = e.what();
+    }
+    auto end = std::chrono::steady_clock::now();
+    registry::releaseArena(); // the parsed structures are gone with the solver's stack, so the next iteration starts empty
+    time = end - start;
+    parseTime = registry::parseEnd ? *registry::parseEnd - start : std::chrono::nanoseconds(0);
+    allocations = alloc::snapshot() - startAllocations;
+  }
+};
+
+
+std::string readInput(int day) {
+  std::stringstream path;
+  path << DATA_PATH << std::setfill('0') << std::setw(2) << day << PATH_SEPARATOR "input.txt";
+  std::ifstream file(path.str(), std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+
+/** Order statistics of one phase in nanoseconds */
+struct Statistics {
+  Statistics() = default;
+  Statistics(std::vector<int64_t> samples) {
+    if (samples.empty()) {
+      return;
+    }
+    std::ranges::sort(samples);
+    auto n = samples.size();
+    min = samples.front();
+    median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    p99 = samples[std::min(n - 1, static_cast<size_t>(std::ceil(n * 0.99)) - 1)];
+  }
+
+  int64_t min = 0;
+  int64_t median = 0;
+  int64_t p99 = 0;
+};
+
+
+struct BenchmarkResult {
+  int day = 0;
+  int iterations = 0;
+  double mean = 0;      // of the total time in ns
+  double ci95 = 0;      // half width of the 95% confidence interval of the mean in ns
+  Statistics parse;
+  Statistics solve;
+
+  void writeJson(std::ostream& out) const {
+    auto phase = [&](const char* name, const Statistics& stats) {
+      out << "\"" << name << "\": {\"min\": " << stats.min << ", \"median\": " << stats.median << ", \"p99\": " << stats.p99 << "}";
+    };
+    out << "{\"day\": " << day << ", \"iterations\": " << iterations << ", \"mean\": " << static_cast<int64_t>(mean)
+        << ", \"ci95\": " << static_cast<int64_t>(ci95) << ", ";
+    phase("parse", parse);
+    out << ", ";
+    phase("solve", solve);
+    out << "}";
+  }
+};
+
+
+/** Runs the given day repeatedly after a warm-up until the 95% confidence interval of the mean total time is tight
+ *  enough (or the iteration/time limit is reached) and collects the parse and solve times separately.
+ */
+BenchmarkResult benchmark(DayRun& run, const Options& options) {
+  for (int i = 0; i < options.warmup; ++i) {
+    run.run();
+  }
+
+  BenchmarkResult result{ .day = run.day };
+  std::vector<int64_t> parseTimes;
+  std::vector<int64_t> solveTimes;
+
+  // Welford's online algorithm for mean and variance of the total time
+  double mean = 0;
+  double m2 = 0;
+  auto start = std::chrono::steady_clock::now();
+  while (true) {
+    run.run();
+    if (!run.result) {
+      break;
+    }
+
+    parseTimes.push_back(run.parseTime.count());
+    solveTimes.push_back((run.time - run.parseTime).count());
+
+    auto n = static_cast<double>(parseTimes.size());
+    auto delta = run.time.count() - mean;
+    mean += delta / n;
+    m2 += delta * (run.time.count() - mean);
+
+    result.ci95 = n > 1 ? 1.96 * std::sqrt(m2 / (n - 1) / n) : 0;
+    if (parseTimes.size() >= options.maxIterations || std::chrono::steady_clock::now() - start >= options.maxTime) {
+      break;
+    }
+    if (parseTimes.size() >= options.minIterations && result.ci95 <= options.precision * mean) {
+      break;
+    }
+  }
+
+  result.iterations = static_cast<int>(parseTimes.size());
+  result.mean = mean;
+  result.parse = Statistics(std::move(parseTimes));
+  result.solve = Statistics(std::move(solveTimes));
+  return result;
+}
+
+
+/** Reads the number following "key": in the given line starting at pos (the JSON files are written by writeJson() with one day per line) */
+std::optional<int64_t> jsonNumber(std::string_view line, std::string_view key, size_t pos = 0) {
+  std::string pattern = "\"" + std::string(key) + "\": ";
+  pos = line.find(pattern, pos);
+  if (pos == std::string_view::npos) {
+    return std::nullopt;
+  }
+  int64_t value = 0;
+  auto begin = line.data() + pos + pattern.size();
+  auto [ptr, ec] = std::from_chars(begin, line.data() + line.size(), value);
+  return ec == std::errc() ? std::optional(value) : std::nullopt;
+}
+
+
+/** Loads the phase medians of a baseline written with --json by day */
+std::map<int, std::pair<int64_t, int64_t>> loadBaseline(const std::string& path) {
+  std::map<int, std::pair<int64_t, int64_t>> baseline;
+  for (auto line : stream::lines(std::ifstream(path))) {
+    auto day = jsonNumber(line, "day");
+    auto parsePos = line.find("\"parse\"");
+    auto solvePos = line.find("\"solve\"");
+    if (!day || parsePos == std::string::npos || solvePos == std::string::npos) {
+      continue;
+    }
+    baseline[*day] = { jsonNumber(line, "median", parsePos).value_or(0), jsonNumber(line, "median", solvePos).value_or(0) };
+  }
+  return baseline;
+}
+
+
+int runBenchmarks(std::vector<DayRun>& runs, const Options& options) {
+  std::vector<BenchmarkResult> results;
+  std::cout << "Day  Iterations      Parse min/median/p99 [ns]               Solve min/median/p99 [ns]\n";
+  for (auto& run : runs) {
+    auto result = benchmark(run, options);
+    if (!run.result) {
+      std::cout << std::setfill('0') << std::setw(2) << run.day << ": Failed: " << run.error << "\n";
+      continue;
+    }
+    std::cout << std::setfill('0') << std::setw(2) << result.day << std::setfill(' ') << std::setw(12) << result.iterations
+              << std::setw(12) << result.parse.min << std::setw(12) << result.parse.median << std::setw(12) << result.parse.p99
+              << std::setw(14) << result.solve.min << std::setw(12) << result.solve.median << std::setw(12) << result.solve.p99 << "\n";
+    results.push_back(result);
+  }
+
+  if (!options.jsonPath.empty()) {
+    std::ofstream out(options.jsonPath);
+    out << "{\"days\": [\n";
+    for (int i = 0; i < results.size(); ++i) {
+      out << "  ";
+      results[i].writeJson(out);
+      out << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+  }
+
+  if (options.baselinePath.empty()) {
+    return 0;
+  }
+
+  int regressions = 0;
+  auto baseline = loadBaseline(options.baselinePath);
+  std::cout << "\nComparison against " << options.baselinePath << " (threshold " << options.threshold * 100 << "%, noise floor "
+            << options.noiseFloor.count() / 1000.0 << "us):\n";
+  for (auto& result : results) {
+    auto entry = baseline.find(result.day);
+    if (entry == baseline.end()) {
+      std::cout << std::setfill('0') << std::setw(2) << result.day << ": not in baseline\n";
+      continue;
+    }
+
+    auto compare = [&](const char* phase, int64_t current, int64_t base) {
+      double change = base > 0 ? static_cast<double>(current - base) / base : 0;
+      std::cout << "  " << phase << ": " << base << "ns -> " << current << "ns (" << std::showpos << std::fixed
+                << std::setprecision(1) << change * 100 << "%" << std::noshowpos << std::defaultfloat << ")";
+      if (change > options.threshold) {
+        if (std::max(current, base) < options.noiseFloor.count()) {
+          std::cout << " (below noise floor)";
+        } else {
+          std::cout << " REGRESSION";
+          ++regressions;
+        }
+      }
+    };
+    std::cout << std::setfill('0') << std::setw(2) << result.day << ":";
+    compare("parse", result.parse.median, entry->second.first);
+    compare("solve", result.solve.median, entry->second.second);
+    std::cout << "\n";
+  }
+
+  std::cout << "\n" << regressions << " Regressions!";
+  return regressions == 0 ? 0 : 1;
+}
+
+
+int main(int argc, char* argv[]) {
+  Options options;
+  std::vector<DayRun> runs;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--parallel") {
+      options.parallel = true;
+    } else if (arg == registry::THREADS_ARG && hasValue) {
+      threads::setThreadCount(static_cast<unsigned>(std::max(0, std::stoi(argv[++i]))));
+    } else if (arg == "--bench") {
+      options.benchmark = true;
+    } else if (arg == "--warmup" && hasValue) {
+      options.warmup = std::max(0, std::stoi(argv[++i]));
+    } else if (arg == "--precision" && hasValue) {
+      options.precision = std::stod(argv[++i]);
+    } else if (arg == "--max-time" && hasValue) {
+      options.maxTime = std::chrono::seconds(std::stoi(argv[++i]));
+    } else if (arg == "--json" && hasValue) {
+      options.jsonPath = argv[++i];
+    } else if (arg == "--baseline" && hasValue) {
+      options.baselinePath = argv[++i];
+    } else if (arg == "--threshold" && hasValue) {
+      options.threshold = std::stod(argv[++i]);
+    } else if (arg == "--noise-floor" && hasValue) {
+      options.noiseFloor = std::chrono::nanoseconds(static_cast<int64_t>(std::stod(argv[++i]) * 1000));
+    } else {
+      int day = std::atoi(argv[i]);
+      if (!registry::solvers().contains(day)) {
+        std::cout << "Unknown option or day: " << arg << "\n";
+        return 1;
+      }
+      runs.push_back(DayRun{ .day = day });
+    }
+  }
+
+  if (runs.empty()) { // run all registered days
+    for (auto& [day, solve] : registry::solvers()) {
+      runs.push_back(DayRun{ .day = day });
+    }
+  }
+
+  for (auto& run : runs) {
+    run.input = readInput(run.day);
+  }
+
+  if (options.benchmark) {
+    // Always sequential, because concurrently running days would distort each other's timings
+    return runBenchmarks(runs, options);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  if (options.parallel) {
+    std::vector<std::jthread> threads;
+    for (auto& run : runs) {
+      threads.emplace_back([&run]() { run.run(); });
+    }
+  } else {
+    for (auto& run : runs) {
+      run.run();
+    }
+  }
+  auto totalTime = std::chrono::steady_clock::now() - start;
+
+
+  auto expectedResults = results::load(std::ifstream(DATA_PATH "results.txt"));
+  int wrongTasks = 0;
+  for (auto& run : runs) {
+    std::cout << std::setfill('0') << std::setw(2) << run.day << ": " << std::setfill(' ') << std::setw(12) << run.time.count() << "ns  ";
+    if (!run.result) {
+      std::cout << "Failed: " << run.error << "\n";
+      ++wrongTasks;
+      continue;
+    }
+
+    std::cout << "Part 1: " << run.result->part1 << ", Part 2: " << run.result->part2;
+    if (run.day <= expectedResults.size() && expectedResults[run.day - 1]) {
+      auto& expected = *expectedResults[run.day - 1];
+      bool okay = run.result->part1 == expected.first && (!expected.second || *expected.second == run.result->part2);
+      std::cout << (okay ? "  OK" : "  WRONG");
+      wrongTasks += okay ? 0 : 1;
+    }
+    if (alloc::ENABLED) {
+      std::cout << "  (" << run.allocations.allocations << " allocations, " << run.allocations.bytes / 1024 << " KiB)";
+    }
+    std::cout << "\n";
+  }
+
+  std::cout << "\nTotal: " << std::chrono::duration_cast<std::chrono::nanoseconds>(totalTime).count() << "ns"
+            << (options.parallel ? " (parallel)" : "") << "\n";
+  std::cout << wrongTasks << " Errors!";
+  return wrongTasks == 0 ? 0 : 1;
+}
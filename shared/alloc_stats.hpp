@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+// Define AOC_COUNT_ALLOCATIONS=1 to replace the global operator new/delete with counting versions. The replacement is
+// defined by ALLOCATION_HOOKS() in the translation unit containing main() (see SOLVER_MAIN), because it must exist
+// only once per executable. Without it, all statistics stay zero and nothing is replaced.
+#ifndef AOC_COUNT_ALLOCATIONS
+#define AOC_COUNT_ALLOCATIONS 0
+#endif
+
+/** Heap allocation statistics of the whole process, counted by the replaced global operator new/delete
+ */
+namespace alloc {
+
+constexpr bool ENABLED = AOC_COUNT_ALLOCATIONS;
+
+struct Stats {
+  int64_t allocations = 0;
+  int64_t bytes = 0;     // allocated in total (freed memory is not subtracted)
+  int64_t peakLive = 0;  // highest number of bytes allocated at the same time
+
+  Stats operator-(const Stats& other) const {
+    return { allocations - other.allocations, bytes - other.bytes, peakLive };
+  }
+};
+
+struct Counters {
+  std::atomic<int64_t> allocations = 0;
+  std::atomic<int64_t> bytes = 0;
+  std::atomic<int64_t> live = 0;
+  std::atomic<int64_t> peakLive = 0;
+};
+
+/** Function local static, so the counters are usable by allocations during static initialization */
+inline Counters& counters() {
+  static Counters counters;
+  return counters;
+}
+
+inline Stats snapshot() {
+  auto& c = counters();
+  return { c.allocations.load(std::memory_order_relaxed), c.bytes.load(std::memory_order_relaxed), c.peakLive.load(std::memory_order_relaxed) };
+}
+
+/** Restarts the peak at the current live bytes, so the next snapshot() reports the peak of the following phase only */
+inline void resetPeak() {
+  auto& c = counters();
+  c.peakLive.store(c.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/** Size of the given block. The usable size is counted instead of the requested size, because it is also known when
+ *  freeing through the unsized operator delete. alignment is 0 for blocks from allocate().
+ */
+inline int64_t blockSize(void* ptr, std::size_t alignment) {
+#ifdef _WIN32
+  return static_cast<int64_t>(alignment ? _aligned_msize(ptr, alignment, 0) : _msize(ptr));
+#else
+  (void)alignment;
+  return static_cast<int64_t>(malloc_usable_size(ptr));
+#endif
+}
+
+inline void recordAllocation(void* ptr, std::size_t alignment) {
+  auto size = blockSize(ptr, alignment);
+  auto& c = counters();
+  c.allocations.fetch_add(1, std::memory_order_relaxed);
+  c.bytes.fetch_add(size, std::memory_order_relaxed);
+  auto live = c.live.fetch_add(size, std::memory_order_relaxed) + size;
+  auto peak = c.peakLive.load(std::memory_order_relaxed);
+  while (live > peak && !c.peakLive.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+inline void recordFree(void* ptr, std::size_t alignment) {
+  counters().live.fetch_sub(blockSize(ptr, alignment), std::memory_order_relaxed);
+}
+
+inline void* allocate(std::size_t size) {
+  if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+    recordAllocation(ptr, 0);
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+inline std::size_t effectiveAlignment(std::align_val_t alignment) {
+  return std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+}
+
+inline void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+  auto align = effectiveAlignment(alignment);
+#ifdef _WIN32
+  auto ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+  auto ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  recordAllocation(ptr, align);
+  return ptr;
+}
+
+inline void deallocate(void* ptr) noexcept {
+  if (ptr) {
+    recordFree(ptr, 0);
+    std::free(ptr);
+  }
+}
+
+inline void deallocateAligned(void* ptr, std::align_val_t alignment) noexcept {
+  if (ptr) {
+    recordFree(ptr, effectiveAlignment(alignment));
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+}
+
+}
+
+#if AOC_COUNT_ALLOCATIONS
+#define ALLOCATION_HOOKS() \
+  void* operator new(std::size_t size) { return alloc::allocate(size); } \
+  void* operator new[](std::size_t size) { return alloc::allocate(size); } \
+  void* operator new(std::size_t size, std::align_val_t alignment) { return alloc::allocateAligned(size, alignment); } \
+  void* operator new[](std::size_t size, std::align_val_t alignment) { return alloc::allocateAligned(size, alignment); } \
+  void operator delete(void* ptr) noexcept { alloc::deallocate(ptr); } \
+  void operator delete[](void* ptr) noexcept { alloc::deallocate(ptr); } \
+  void operator delete(void* ptr, std::size_t) noexcept { alloc::deallocate(ptr); } \
+  void operator delete[](void* ptr, std::size_t) noexcept { alloc::deallocate(ptr); } \
+  void operator delete(void* ptr, std::align_val_t alignment) noexcept { alloc::deallocateAligned(ptr, alignment); } \
+  void operator delete[](void* ptr, std::align_val_t alignment) noexcept { alloc::deallocateAligned(ptr, alignment); } \
+  void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { alloc::deallocateAligned(ptr, alignment); } \
+  void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { alloc::deallocateAligned(ptr, alignment); }
+#else
+#define ALLOCATION_HOOKS()
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/** Monotonic arena for the parsed structures of a solver run (see registry::arena()).
+ */
+namespace arena {
+
+/** Bump allocator as std::pmr::memory_resource: allocating advances a pointer within the current chunk and deallocating
+ *  does nothing. Unlike std::pmr::monotonic_buffer_resource, release() keeps the chunks for the next run, so repeated
+ *  runs of the same day (the benchmark loop of run_all) allocate from the heap only during the first run.
+ *
+ *  Not thread safe: an arena must only be used by the thread, which owns it.
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+  static constexpr size_t INITIAL_CHUNK_SIZE = 64 * 1024;
+
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /** Frees everything allocated from this arena at once. Memory from before the release must not be used anymore */
+  void release() {
+    current = 0;
+    cursor = chunks.empty() ? nullptr : chunks.front().data.get();
+    used = 0;
+  }
+
+  /** Bytes handed out since the last release() (including alignment padding) */
+  size_t bytesUsed() const {
+    return used;
+  }
+
+  /** Bytes reserved from the heap by all chunks */
+  size_t bytesReserved() const {
+    size_t total = 0;
+    for (auto& chunk : chunks) {
+      total += chunk.size;
+    }
+    return total;
+  }
+
+private:
+  struct Chunk {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+
+    std::byte* end() const {
+      return data.get() + size;
+    }
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    while (true) {
+      if (cursor) {
+        auto aligned = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1));
+        if (aligned + bytes <= chunks[current].end()) {
+          used += aligned + bytes - cursor;
+          cursor = aligned + bytes;
+          return aligned;
+        }
+      }
+      nextChunk(bytes + alignment);
+    }
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {
+    // freed all at once by release()
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  /** Continues in the next retained chunk or allocates a new one, which is large enough for minSize bytes */
+  void nextChunk(size_t minSize) {
+    if (cursor) {
+      ++current;
+    }
+    // Retained chunks, which are too small for this allocation, stay unused until the next release()
+    while (current < chunks.size() && chunks[current].size < minSize) {
+      ++current;
+    }
+    if (current == chunks.size()) {
+      auto size = std::max(minSize, chunks.empty() ? INITIAL_CHUNK_SIZE : 2 * chunks.back().size);
+      chunks.push_back(Chunk{ std::make_unique_for_overwrite<std::byte[]>(size), size });
+    }
+    cursor = chunks[current].data.get();
+  }
+
+  std::vector<Chunk> chunks;
+  size_t current = 0;
+  std::byte* cursor = nullptr;
+  size_t used = 0;
+};
+
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <common/vector.hpp>
+#include <common/vector3d.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#else
+#define FLAT_HASH_SSE2 0
+#endif
+
+/** Open addressing hash containers in the style of the Swiss tables: the slots are stored in one flat array and every
+ *  slot has a control byte, which is either EMPTY or holds 7 bits of the key's hash. Lookups probe groups of 16 control
+ *  bytes at once (with SSE2 where available) and only compare the keys of slots with a matching tag, so a lookup
+ *  usually touches one group of control bytes and one slot instead of chasing the node pointers of std::unordered_set.
+ *
+ *  Keys and values must be default constructible, because all slots are constructed up front. Elements can't be erased,
+ *  which none of the days needs and which keeps the probing free of tombstones.
+ */
+namespace flat {
+
+/** Finalizer of MurmurHash3: spreads every input bit over all output bits, so the low bits (used for the group index)
+ *  and the high bits (used for the tag) are both well distributed even for small coordinates.
+ */
+inline uint64_t mix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+/** Folds another value into a hash, which must be passed through mix() at the end */
+inline uint64_t combine(uint64_t hash, uint64_t value) {
+  return std::rotl(hash, 23) * 0x9e3779b97f4a7c15ull ^ value;
+}
+
+template<typename Key>
+struct Hash;
+
+template<>
+struct Hash<Vector> {
+  uint64_t operator()(const Vector& v) const {
+    return mix(static_cast<uint64_t>(static_cast<uint32_t>(v.x)) << 32 | static_cast<uint32_t>(v.y));
+  }
+};
+
+template<>
+struct Hash<Vector3D> {
+  uint64_t operator()(const Vector3D& v) const {
+    return mix(combine(static_cast<uint64_t>(static_cast<uint32_t>(v.x)) << 32 | static_cast<uint32_t>(v.y), static_cast<uint32_t>(v.z)));
+  }
+};
+
+
+constexpr size_t GROUP_SIZE = 16;
+constexpr uint8_t EMPTY = 0x80;
+
+/** Bit i of the result is set if control byte i of the group equals the given byte */
+inline uint32_t matchGroup(const uint8_t* group, uint8_t byte) {
+#if FLAT_HASH_SSE2
+  auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(byte)))));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < GROUP_SIZE; ++i) {
+    mask |= static_cast<uint32_t>(group[i] == byte) << i;
+  }
+  return mask;
+#endif
+}
+
+
+/** Storage and probing shared by HashSet and HashMap. KeyOf extracts the key from a slot */
+template<typename Key, typename Slot, typename KeyOf, typename HashFn>
+class Table {
+public:
+  template<typename TableT, typename SlotT>
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Slot;
+    using difference_type = std::ptrdiff_t;
+    using pointer = SlotT*;
+    using reference = SlotT&;
+
+    Iterator() = default;
+    Iterator(TableT* table, size_t index) : table(table), index(index) {
+      skipEmpty();
+    }
+
+    reference operator*() const { return table->slots[index]; }
+    pointer operator->() const { return &table->slots[index]; }
+
+    Iterator& operator++() {
+      ++index;
+      skipEmpty();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return index == other.index; }
+
+  private:
+    void skipEmpty() {
+      while (index < table->ctrl.size() && table->ctrl[index] == EMPTY) {
+        ++index;
+      }
+    }
+
+    TableT* table = nullptr;
+    size_t index = 0;
+  };
+
+  using iterator = Iterator<Table, Slot>;
+  using const_iterator = Iterator<const Table, const Slot>;
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, ctrl.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, ctrl.size()); }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  /** Sizes the table, so that at least n elements fit without rehashing */
+  void reserve(size_t n) {
+    if (n > maxLoad(ctrl.size())) {
+      rehash(std::bit_ceil(std::max(GROUP_SIZE, (n * 8 + 6) / 7)));
+    }
+  }
+
+  void clear() {
+    std::fill(ctrl.begin(), ctrl.end(), EMPTY);
+    count = 0;
+  }
+
+  iterator find(const Key& key) {
+    auto [index, found] = locate(key);
+    return found ? iterator(this, index) : end();
+  }
+
+  const_iterator find(const Key& key) const {
+    auto [index, found] = locate(key);
+    return found ? const_iterator(this, index) : end();
+  }
+
+  bool contains(const Key& key) const {
+    return locate(key).second;
+  }
+
+protected:
+  /** Index of the slot of the key and true, or the slot to insert the key into and false */
+  std::pair<size_t, bool> locate(const Key& key) const {
+    if (ctrl.empty()) {
+      return { 0, false };
+    }
+
+    auto hash = HashFn()(key);
+    auto tag = static_cast<uint8_t>(hash >> 57);
+    auto groupMask = ctrl.size() / GROUP_SIZE - 1;
+    auto group = static_cast<size_t>(hash) & groupMask;
+    // Triangular probing visits every group once, because the number of groups is a power of two
+    for (size_t step = 1; true; ++step) {
+      auto groupCtrl = ctrl.data() + group * GROUP_SIZE;
+      for (auto match = matchGroup(groupCtrl, tag); match; match &= match - 1) {
+        auto index = group * GROUP_SIZE + std::countr_zero(match);
+        if (KeyOf()(slots[index]) == key) {
+          return { index, true };
+        }
+      }
+      if (auto empty = matchGroup(groupCtrl, EMPTY)) {
+        return { group * GROUP_SIZE + std::countr_zero(empty), false };
+      }
+      group = (group + step) & groupMask;
+    }
+  }
+
+  /** Slot of the key and true if it was inserted, which must be filled by the caller in that case */
+  std::pair<size_t, bool> insertSlot(const Key& key) {
+    auto [index, found] = locate(key);
+    if (found) {
+      return { index, false };
+    }
+    if (count + 1 > maxLoad(ctrl.size())) {
+      rehash(std::max(GROUP_SIZE, ctrl.size() * 2));
+      index = locate(key).first;
+    }
+    ctrl[index] = static_cast<uint8_t>(HashFn()(key) >> 57);
+    ++count;
+    return { index, true };
+  }
+
+  std::vector<uint8_t> ctrl;
+  std::vector<Slot> slots;
+  size_t count = 0;
+
+private:
+  /** Maximum number of elements for the given capacity (7/8 load factor) */
+  static size_t maxLoad(size_t capacity) {
+    return capacity / 8 * 7;
+  }
+
+  void rehash(size_t capacity) {
+    assert(std::has_single_bit(capacity) && capacity >= GROUP_SIZE);
+    auto oldCtrl = std::exchange(ctrl, std::vector<uint8_t>(capacity, EMPTY));
+    auto oldSlots = std::exchange(slots, std::vector<Slot>(capacity));
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+      if (oldCtrl[i] != EMPTY) {
+        auto index = locate(KeyOf()(oldSlots[i])).first;
+        ctrl[index] = oldCtrl[i];
+        slots[index] = std::move(oldSlots[i]);
+      }
+    }
+  }
+};
+
+
+struct Identity {
+  template<typename T>
+  const T& operator()(const T& value) const { return value; }
+};
+
+struct First {
+  template<typename T>
+  const auto& operator()(const T& pair) const { return pair.first; }
+};
+
+
+template<typename Key, typename HashFn = Hash<Key>>
+class HashSet : public Table<Key, Key, Identity, HashFn> {
+public:
+  HashSet() = default;
+  explicit HashSet(size_t expectedSize) {
+    this->reserve(expectedSize);
+  }
+
+  std::pair<typename HashSet::const_iterator, bool> insert(const Key& key) {
+    auto [index, inserted] = this->insertSlot(key);
+    if (inserted) {
+      this->slots[index] = key;
+    }
+    return { typename HashSet::const_iterator(this, index), inserted };
+  }
+};
+
+
+template<typename Key, typename Value, typename HashFn = Hash<Key>>
+class HashMap : public Table<Key, std::pair<Key, Value>, First, HashFn> {
+public:
+  HashMap() = default;
+  explicit HashMap(size_t expectedSize) {
+    this->reserve(expectedSize);
+  }
+
+  std::pair<typename HashMap::iterator, bool> insert(const Key& key, const Value& value) {
+    auto [index, inserted] = this->insertSlot(key);
+    if (inserted) {
+      this->slots[index] = { key, value };
+    }
+    return { typename HashMap::iterator(this, index), inserted };
+  }
+
+  /** Value of the key, which is default constructed if the key wasn't present */
+  Value& operator[](const Key& key) {
+    auto [index, inserted] = this->insertSlot(key);
+    if (inserted) {
+      this->slots[index] = { key, Value() };
+    }
+    return this->slots[index].second;
+  }
+};
+
+}
@@ -0,0 +1,79 @@
+#include <shared/input.hpp>
+
+// The platform headers of the file mapping are only included by this translation unit, so they don't end up in the days
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace input {
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+  auto fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  file = fileHandle;
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(fileHandle, &fileSize);
+  size = static_cast<size_t>(fileSize.QuadPart);
+  opened = true;
+  if (size == 0) {
+    return; // empty files can't be mapped
+  }
+  mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  data = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+  opened = data != nullptr;
+#else
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return;
+  }
+  struct stat status;
+  if (fstat(fd, &status) == 0) {
+    size = static_cast<size_t>(status.st_size);
+    opened = true;
+    if (size > 0) {
+      auto mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        opened = false;
+      } else {
+        data = static_cast<const char*>(mapped);
+        madvise(mapped, size, MADV_SEQUENTIAL);
+      }
+    }
+  }
+  close(fd); // the mapping stays valid
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  if (file) {
+    CloseHandle(file);
+  }
+#else
+  if (data) {
+    munmap(const_cast<char*>(data), size);
+  }
+#endif
+}
+
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/** Zero-copy access to the puzzle input: the file is memory mapped and parsed directly from the mapping with the
+ *  std::from_chars based Scanner, so neither the file content nor single lines or numbers are copied into strings.
+ */
+namespace input {
+
+/** Read-only memory mapping of a whole file. valid() is false if the file couldn't be opened or mapped.
+ *  The constructor and destructor are defined in input.cpp, which keeps the platform headers out of the days.
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool valid() const {
+    return opened;
+  }
+
+  std::string_view view() const {
+    return data ? std::string_view(data, size) : std::string_view();
+  }
+
+private:
+  const char* data = nullptr;
+  size_t size = 0;
+  bool opened = false;
+#ifdef _WIN32
+  void* file = nullptr; // HANDLEs
+  void* mapping = nullptr;
+#endif
+};
+
+
+/** Iterator over the lines of a buffer as string_views without the line ends (see lines())
+ */
+class LineIterator {
+public:
+  using value_type = std::string_view;
+  using difference_type = std::ptrdiff_t;
+
+  LineIterator() = default;
+  LineIterator(std::string_view buffer) : next(buffer.data()), end(buffer.data() + buffer.size()) {
+    ++*this;
+  }
+
+  std::string_view operator*() const {
+    return line;
+  }
+
+  LineIterator& operator++() {
+    if (next == end) {
+      atEnd = true;
+      return *this;
+    }
+
+    // OPTIMIZATION: memchr is vectorized by all standard libraries, so this scans 16-32 bytes per step for the newline
+    auto newline = static_cast<const char*>(std::memchr(next, '\n', end - next));
+    line = std::string_view(next, newline ? newline : end);
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+    next = newline ? newline + 1 : end;
+    return *this;
+  }
+
+  LineIterator operator++(int) {
+    auto copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  bool operator==(std::default_sentinel_t) const {
+    return atEnd;
+  }
+
+private:
+  const char* next = nullptr;
+  const char* end = nullptr;
+  std::string_view line;
+  bool atEnd = false;
+};
+
+/** All lines of the given buffer without allocating. A newline at the end of the buffer doesn't produce an empty last line. */
+inline auto lines(std::string_view buffer) {
+  return std::ranges::subrange(LineIterator(buffer), std::default_sentinel);
+}
+
+
+/** Cursor over the input with a few scanners for the formats of the puzzle inputs. The scanners don't skip anything
+ *  implicitly, separators must be consumed with skip() and line ends with nextLine() or skipWhitespace().
+ */
+struct Scanner {
+  explicit Scanner(std::string_view input) : rest(input), start(input.data()) {}
+
+  bool empty() const {
+    return rest.empty();
+  }
+
+  /** Next character without consuming it ('\0' at the end) */
+  char peek() const {
+    return rest.empty() ? '\0' : rest.front();
+  }
+
+  char next() {
+    assert(!rest.empty());
+    char ch = rest.front();
+    rest.remove_prefix(1);
+    return ch;
+  }
+
+  /** Consumes the given character if it is next */
+  bool skip(char ch) {
+    if (peek() != ch) {
+      return false;
+    }
+    rest.remove_prefix(1);
+    return true;
+  }
+
+  /** Skips spaces and line ends */
+  void skipWhitespace() {
+    while (!rest.empty() && (rest.front() == ' ' || rest.front() == '\n' || rest.front() == '\r')) {
+      rest.remove_prefix(1);
+    }
+  }
+
+  /** Parses a (signed) integer at the current position */
+  template<std::integral T>
+  bool integer(T& value) {
+    auto [end, error] = std::from_chars(rest.data(), rest.data() + rest.size(), value);
+    if (error != std::errc()) {
+      return false;
+    }
+    rest.remove_prefix(end - rest.data());
+    return true;
+  }
+
+  /** Parses the integer at the current position, which must be there. Throws on malformed input, because the parse
+   *  loops would otherwise get 0 at the same position over and over again
+   */
+  template<std::integral T>
+  T integer() {
+    T value = 0;
+    if (!integer(value)) {
+      throw std::runtime_error("Expected an integer at offset " + std::to_string(rest.data() - start) + ": \""
+                               + std::string(rest.substr(0, std::min<size_t>(rest.find_first_of("\r\n"), 20))) + "\"");
+    }
+    return value;
+  }
+
+  /** Parses integers separated by the given separator (e.g. "1,2,3") and passes each of them to the callback */
+  template<std::integral T, typename Callback>
+  void list(char separator, Callback&& callback) {
+    do {
+      callback(integer<T>());
+    } while (skip(separator));
+  }
+
+  /** Returns the rest of the current line (without "\r\n" or "\n") and moves to the next line */
+  std::string_view nextLine() {
+    auto lineEnd = rest.find('\n');
+    auto line = rest.substr(0, lineEnd);
+    rest.remove_prefix(lineEnd == std::string_view::npos ? rest.size() : lineEnd + 1);
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
+    }
+    return line;
+  }
+
+  std::string_view rest;
+
+private:
+  const char* start; // of the input, for the offsets in error messages
+};
+
+}
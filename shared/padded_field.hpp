@@ -0,0 +1,96 @@
+#pragma once
+
+#include <common/vector.hpp>
+#include <shared/input.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/** Grid like FieldT<T>, but surrounded by a border of `padding` sentinel cells on every side. Every in-field cell has
+ *  all neighbours within `padding` steps inside the buffer, so stencil loops can walk raw offsets with the precomputed
+ *  strides in `neighbours` (or step()) without any bounds checks. Out-of-field neighbours read as the border value.
+ */
+template<typename T>
+class PaddedFieldT {
+public:
+  /** Parses the field from the lines of the input. All lines must have the same length */
+  PaddedFieldT(std::string_view input, const T& border, int padding = 1) : padding(padding) {
+    assert(padding >= 1);
+    std::vector<std::string_view> rows;
+    for (auto line : input::lines(input)) {
+      rows.push_back(line);
+    }
+    while (!rows.empty() && rows.back().empty()) {
+      rows.pop_back();
+    }
+
+    width = rows.empty() ? 0 : static_cast<int>(rows.front().size());
+    height = static_cast<int>(rows.size());
+    stride = width + 2 * padding;
+    size_t direction = 0;
+    for (auto delta : Vector::AllDirections()) {
+      neighbours[direction++] = step(delta);
+    }
+
+    data.reserve(static_cast<size_t>(stride) * (height + 2 * padding));
+    data.resize(static_cast<size_t>(stride) * padding, border);
+    for (auto row : rows) {
+      assert(static_cast<int>(row.size()) == width);
+      data.insert(data.end(), padding, border);
+      for (auto ch : row) {
+        data.emplace_back(ch);
+      }
+      data.insert(data.end(), padding, border);
+    }
+    data.resize(data.size() + static_cast<size_t>(stride) * padding, border);
+  }
+
+  /** Linear distance of a neighbour in the given direction */
+  ptrdiff_t step(const Vector& direction) const {
+    return direction.y * stride + direction.x;
+  }
+
+  size_t toOffset(const Vector& pos) const {
+    return static_cast<size_t>(pos.y + padding) * stride + pos.x + padding;
+  }
+
+  Vector fromOffset(size_t offset) const {
+    return Vector(static_cast<int>(offset % stride) - padding, static_cast<int>(offset / stride) - padding);
+  }
+
+  /** Offset of the first cell of row y inside the field */
+  size_t rowBegin(int y) const {
+    return toOffset(Vector(0, y));
+  }
+
+  /** Offset behind the last cell of row y inside the field */
+  size_t rowEnd(int y) const {
+    return rowBegin(y) + width;
+  }
+
+  /** Offset of the first cell with the given value (data.size() if there is none) */
+  size_t findOffset(const T& value) const {
+    return std::find(data.begin(), data.end(), value) - data.begin();
+  }
+
+  T& operator[](const Vector& pos) {
+    return data[toOffset(pos)];
+  }
+
+  const T& operator[](const Vector& pos) const {
+    return data[toOffset(pos)];
+  }
+
+  std::vector<T> data;
+  int width = 0;
+  int height = 0;
+  int padding;
+  ptrdiff_t stride = 0;
+  std::array<ptrdiff_t, 8> neighbours;  // step() of Vector::AllDirections() in the same order
+};
+
+using PaddedField = PaddedFieldT<char>;
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/** Hardware performance counters attributed to the named phases of a single solver run (see registry::runDay).
+ *  The phases are consecutive: checkpoint() ends the current phase and the next one starts right away.
+ *  Counting is based on perf_event_open() and therefore only available on Linux. Counters which can't be opened
+ *  (no PMU in a VM, restrictive perf_event_paranoid, other OS) are reported as unavailable instead of failing the run.
+ */
+namespace perf {
+
+enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, PAGE_FAULTS, EVENT_COUNT };
+
+constexpr std::array<std::string_view, EVENT_COUNT> EVENT_NAMES = {
+  "cycles", "instructions", "L1d misses", "LLC misses", "branch misses", "page faults"
+};
+
+using Values = std::array<std::optional<uint64_t>, EVENT_COUNT>;
+
+struct Sample {
+  std::chrono::steady_clock::time_point time;
+  Values values;
+};
+
+
+/** One counter per event for this process, including all threads started after opening them
+ */
+class Counters {
+public:
+  Counters() {
+    fds.fill(-1);
+#ifdef __linux__
+    constexpr uint64_t L1D_READ_MISS = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    std::array<std::pair<uint32_t, uint64_t>, EVENT_COUNT> events = { {
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+      { PERF_TYPE_HW_CACHE, L1D_READ_MISS },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+      { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    } };
+
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+      perf_event_attr attr = {};
+      attr.size = sizeof(attr);
+      attr.type = events[event].first;
+      attr.config = events[event].second;
+      attr.inherit = 1; // also count the worker threads of parallel days
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds[event] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+#endif
+  }
+
+  ~Counters() {
+#ifdef __linux__
+    for (auto fd : fds) {
+      if (fd != -1) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  Counters(const Counters&) = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  /** True if at least one hardware (not software) event can be counted */
+  bool hardwareAvailable() const {
+    return fds[CYCLES] != -1 || fds[INSTRUCTIONS] != -1 || fds[L1D_MISSES] != -1 || fds[LLC_MISSES] != -1 || fds[BRANCH_MISSES] != -1;
+  }
+
+  Sample read() const {
+    Sample sample{ std::chrono::steady_clock::now(), {} };
+#ifdef __linux__
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+      struct { uint64_t value, timeEnabled, timeRunning; } data;
+      if (fds[event] != -1 && ::read(fds[event], &data, sizeof(data)) == sizeof(data)) {
+        // Scale up, if the kernel had to multiplex the counters
+        sample.values[event] = data.timeRunning == 0 || data.timeRunning == data.timeEnabled ? data.value :
+          static_cast<uint64_t>(static_cast<double>(data.value) * data.timeEnabled / data.timeRunning);
+      }
+    }
+
+    if (fds[PAGE_FAULTS] == -1) {
+      // Page faults are also available without perf events
+      rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        sample.values[PAGE_FAULTS] = usage.ru_minflt + usage.ru_majflt;
+      }
+    }
+#endif
+    return sample;
+  }
+
+private:
+  std::array<int, EVENT_COUNT> fds;
+};
+
+
+struct Phase {
+  std::string name;
+  int64_t ns = 0;
+  Values values;
+};
+
+
+/** Accumulates the counter differences between consecutive checkpoints per phase name */
+class Recorder {
+public:
+  Recorder() : last(counters.read()) {}
+
+  void checkpoint(std::string_view phaseName) {
+    std::unique_lock lock(mtx);
+    auto sample = counters.read();
+
+    auto phase = std::find_if(phases.begin(), phases.end(), [&](const Phase& phase) { return phase.name == phaseName; });
+    if (phase == phases.end()) {
+      phase = phases.insert(phases.end(), Phase{ std::string(phaseName), 0, {} });
+    }
+    phase->ns += std::chrono::duration_cast<std::chrono::nanoseconds>(sample.time - last.time).count();
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+      if (sample.values[event] && last.values[event]) {
+        phase->values[event] = phase->values[event].value_or(0) + (*sample.values[event] - *last.values[event]);
+      }
+    }
+    last = sample;
+  }
+
+  /** Prints one row per phase in the order they were first reached */
+  void print(std::ostream& out) const {
+    std::unique_lock lock(mtx);
+    out << "\n" << std::left << std::setw(12) << "Phase" << std::right << std::setw(12) << "Time [ms]";
+    for (auto name : EVENT_NAMES) {
+      out << std::setw(16) << name;
+    }
+    out << std::setw(8) << "IPC" << "\n";
+
+    for (auto& phase : phases) {
+      out << std::left << std::setw(12) << phase.name << std::right
+        << std::setw(12) << std::fixed << std::setprecision(3) << phase.ns / 1e6 << std::defaultfloat;
+      for (auto& value : phase.values) {
+        out << std::setw(16);
+        if (value) {
+          out << *value;
+        } else {
+          out << "n/a";
+        }
+      }
+
+      auto& cycles = phase.values[CYCLES];
+      auto& instructions = phase.values[INSTRUCTIONS];
+      std::ostringstream ipc;
+      if (cycles && instructions && *cycles > 0) {
+        ipc << std::fixed << std::setprecision(2) << static_cast<double>(*instructions) / *cycles;
+      } else {
+        ipc << "n/a";
+      }
+      out << std::setw(8) << ipc.str() << "\n";
+    }
+
+    if (!counters.hardwareAvailable()) {
+      out << "Hardware counters are unavailable (not Linux, no PMU or restricted by /proc/sys/kernel/perf_event_paranoid)\n";
+    }
+  }
+
+private:
+  Counters counters;
+  Sample last;
+  std::vector<Phase> phases;
+  mutable std::mutex mtx;
+};
+
+
+/** The recorder of the current run, null while counting is disabled (the default) */
+inline std::unique_ptr<Recorder> activeRecorder;
+
+/** Opens the counters, everything until the first checkpoint() belongs to the first phase */
+inline void start() {
+  activeRecorder = std::make_unique<Recorder>();
+}
+
+/** Ends the current phase under the given name. Does nothing unless start() was called, so solvers can always call it */
+inline void checkpoint(std::string_view phaseName) {
+  if (activeRecorder) {
+    activeRecorder->checkpoint(phaseName);
+  }
+}
+
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** Hierarchical scoped timers: PROFILE_SCOPE("name") times the rest of the enclosing block as a region, which is nested
+ *  into the region that was open on the same thread when it started. Each thread records into its own tree without
+ *  locking, the trees are merged by region path in report(). Per region the number of calls, the total time and the
+ *  self time (total minus the time of nested regions) are aggregated.
+ *
+ *  Recording is off unless enable() was called (see registry::PROFILE_ARG), then a region costs two clock reads and a
+ *  short linear search among the children of the current region. Region names must be string literals (or otherwise outlive
+ *  the report), because only the pointers are stored.
+ */
+namespace profile {
+
+struct Node {
+  Node(const char* name, Node* parent) : name(name), parent(parent) {}
+
+  /** Child region with the given name, created on first use */
+  Node* child(const char* childName) {
+    for (auto& node : children) {
+      if (node->name == childName || std::strcmp(node->name, childName) == 0) {
+        return node.get();
+      }
+    }
+    return children.emplace_back(std::make_unique<Node>(childName, this)).get();
+  }
+
+  const char* name;
+  Node* parent;
+  std::vector<std::unique_ptr<Node>> children;
+  int64_t calls = 0;
+  int64_t totalNs = 0;
+};
+
+
+/** The trees of all threads, which ever recorded a region. Owned here, so they survive the end of their worker thread */
+struct Trees {
+  std::mutex mtx;
+  std::vector<std::unique_ptr<Node>> roots;
+};
+
+inline Trees& trees() {
+  static Trees trees;
+  return trees;
+}
+
+inline bool enabled = false;
+
+/** Starts recording. Must be called before any worker threads are started */
+inline void enable() {
+  enabled = true;
+}
+
+/** Region, which is currently open on this thread (the thread's root node if none is open) */
+inline Node*& currentNode() {
+  thread_local Node* current = nullptr;
+  if (!current) {
+    auto& allTrees = trees();
+    std::unique_lock lock(allTrees.mtx);
+    current = allTrees.roots.emplace_back(std::make_unique<Node>("", nullptr)).get();
+  }
+  return current;
+}
+
+
+class Scope {
+public:
+  explicit Scope(const char* name) {
+    if (enabled) {
+      auto& current = currentNode();
+      node = current->child(name);
+      current = node;
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~Scope() {
+    if (node) {
+      node->totalNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      ++node->calls;
+      currentNode() = node->parent;
+    }
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  Node* node = nullptr;
+  std::chrono::steady_clock::time_point start;
+};
+
+
+/** Aggregated region of the report. Totals are summed over all threads, so parallel regions may exceed the wall time */
+struct Region {
+  int64_t calls = 0;
+  int64_t totalNs = 0;
+  int64_t childrenNs = 0;
+  std::map<std::string, Region> children;
+
+  int64_t selfNs() const {
+    return std::max<int64_t>(0, totalNs - childrenNs);
+  }
+};
+
+inline void merge(const Node& node, Region& region, std::map<std::string, Region>& byName) {
+  for (auto& child : node.children) {
+    auto& childRegion = region.children[child->name];
+    childRegion.calls += child->calls;
+    childRegion.totalNs += child->totalNs;
+    region.childrenNs += child->totalNs;
+
+    int64_t grandChildrenNs = 0;
+    for (auto& grandChild : child->children) {
+      grandChildrenNs += grandChild->totalNs;
+    }
+    auto& named = byName[child->name];
+    named.calls += child->calls;
+    named.totalNs += child->totalNs;
+    named.childrenNs += grandChildrenNs;
+
+    merge(*child, childRegion, byName);
+  }
+}
+
+inline void printRegion(std::ostream& out, const std::string& name, const Region& region, int depth) {
+  out << std::left << std::setw(40) << (std::string(2 * depth, ' ') + name) << std::right
+    << std::setw(10) << region.calls << std::fixed << std::setprecision(3)
+    << std::setw(14) << region.totalNs / 1e6
+    << std::setw(14) << region.selfNs() / 1e6 << "\n" << std::defaultfloat;
+  for (auto& [childName, child] : region.children) {
+    printRegion(out, childName, child, depth + 1);
+  }
+}
+
+/** Prints the merged tree of all regions followed by a flat list of all region names (summed over all their paths) by
+ *  self time. Regions of worker threads appear as top-level regions, because they were not opened within another region
+ *  of their thread.
+ */
+inline void report(std::ostream& out) {
+  Region root;
+  std::map<std::string, Region> byName;
+  {
+    auto& allTrees = trees();
+    std::unique_lock lock(allTrees.mtx);
+    for (auto& tree : allTrees.roots) {
+      merge(*tree, root, byName);
+    }
+  }
+
+  out << "\n" << std::left << std::setw(40) << "Region" << std::right << std::setw(10) << "Calls"
+    << std::setw(14) << "Total [ms]" << std::setw(14) << "Self [ms]" << "\n";
+  for (auto& [name, region] : root.children) {
+    printRegion(out, name, region, 0);
+  }
+
+  std::vector<std::pair<std::string, Region>> flat(byName.begin(), byName.end());
+  std::ranges::sort(flat, std::greater<>(), [](const auto& entry) { return entry.second.selfNs(); });
+  out << "\nBy self time (summed over all paths)\n";
+  for (auto& [name, region] : flat) {
+    region.children.clear();
+    printRegion(out, name, region, 0);
+  }
+}
+
+}
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) profile::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <common/time.hpp>
+#include <common/task.hpp>
+#include <shared/alloc_stats.hpp>
+#include <shared/arena.hpp>
+#include <shared/input.hpp>
+#include <shared/perf_counters.hpp>
+#include <shared/profile.hpp>
+#include <shared/thread_pool.hpp>
+
+#include <map>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstdint>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+
+/** Registry of all day solvers, so that they can be run in-process by a single driver (see run_all) as well as by
+ *  the per-day executables, which are thin wrappers around the same solve function.
+ */
+namespace registry {
+
+/** Results of both parts as text, so that days are free to produce any printable type */
+struct Result {
+  Result(std::string part1, std::string part2) : part1(std::move(part1)), part2(std::move(part2)) {}
+  Result(int64_t part1, int64_t part2) : part1(std::to_string(part1)), part2(std::to_string(part2)) {}
+
+  std::string part1;
+  std::string part2;
+};
+
+/** Solves both parts of a day for the given puzzle input */
+using SolveFn = Result(*)(std::string_view input);
+
+/** All registered solvers by day. Function local static, so registration works regardless of static initialization order */
+inline std::map<int, SolveFn>& solvers() {
+  static std::map<int, SolveFn> solvers;
+  return solvers;
+}
+
+struct Registration {
+  Registration(int day, SolveFn solve) {
+    solvers().emplace(day, solve);
+  }
+};
+
+/** Time at which the solver on this thread finished parsing its input. Reset by the caller before each solve() */
+inline thread_local std::optional<std::chrono::steady_clock::time_point> parseEnd;
+
+/** Allocation statistics at the time of parseEnd (only when counting allocations, see alloc::ENABLED) */
+inline thread_local std::optional<alloc::Stats> parseEndAllocations;
+
+/** Called by each solver after parsing its input, which separates the parse from the solve phase in benchmarks */
+inline void parsed() {
+  parseEnd = std::chrono::steady_clock::now();
+  if (alloc::ENABLED) {
+    parseEndAllocations = alloc::snapshot();
+    alloc::resetPeak();
+  }
+  perf::checkpoint("parse");
+}
+
+/** Arena for the structures parsed by the solver on this thread. Everything allocated from it is freed at once after
+ *  the solver returns (see releaseArena()), so it must not be used for anything that outlives solve() or for
+ *  allocations by worker threads.
+ */
+inline arena::Arena& arena() {
+  thread_local arena::Arena arena;
+  return arena;
+}
+
+/** Called by the driver after each solve(). The chunks are kept, so repeated runs don't allocate again */
+inline void releaseArena() {
+  arena().release();
+}
+
+/** Optionally called by solvers after further phases (e.g. "part1"), to which the performance counters are attributed
+ *  when run with COUNTERS_ARG. Everything after the last phase is reported as "solve".
+ */
+inline void phase(std::string_view name) {
+  perf::checkpoint(name);
+}
+
+/** Days which parse from a stream get a copy of the input to read from */
+inline std::istringstream inputStream(std::string_view input) {
+  return std::istringstream(std::string(input));
+}
+
+/** Path of the given solver's input in the data directory relative to its project directory (the working directory
+ *  of the per-day executables), empty if the solver isn't registered.
+ */
+inline std::string defaultInputPath(SolveFn solve) {
+  for (auto& [day, registered] : solvers()) {
+    if (registered == solve) {
+      std::ostringstream path;
+      path << "../data/" << std::setfill('0') << std::setw(2) << day << "/input.txt";
+      return path.str();
+    }
+  }
+  return {};
+}
+
+/** Argument, which switches the per-day executables to the structured output read by check_all */
+constexpr std::string_view STRUCTURED_OUTPUT_ARG = "--structured";
+
+/** Argument followed by a path, which makes the per-day executables read that file instead of the task input */
+constexpr std::string_view INPUT_ARG = "--input";
+
+/** Argument, which prints the hardware performance counters per phase after the results (see perf::Recorder) */
+constexpr std::string_view COUNTERS_ARG = "--counters";
+
+/** Argument, which prints the tree of profile regions (see PROFILE_SCOPE) after the results */
+constexpr std::string_view PROFILE_ARG = "--profile";
+
+/** Argument followed by the number of threads of the shared thread pool (see threads::setThreadCount()) */
+constexpr std::string_view THREADS_ARG = "--threads";
+
+/** Every line of the structured output starts with this prefix, so any other output of a day is simply ignored */
+constexpr std::string_view STRUCTURED_PREFIX = "@aoc ";
+
+/** Peak memory usage of this process in KiB (defined in registry.cpp, which keeps the platform headers out of the days) */
+int64_t peakMemoryKiB();
+
+/** Results and measurements of one run of a per-day executable as written with STRUCTURED_OUTPUT_ARG:
+ *
+ *    @aoc part1 <value>
+ *    @aoc part2 <value>
+ *    @aoc parse_ns <time until registry::parsed() was called>
+ *    @aoc solve_ns <remaining time of solve()>
+ *    @aoc peak_memory_kib <peak memory of the process>
+ */
+struct StructuredOutput {
+  std::optional<std::string> part1;
+  std::optional<std::string> part2;
+  int64_t parseNs = 0;
+  int64_t solveNs = 0;
+  int64_t peakMemoryKiB = 0;
+  std::optional<int64_t> parseAllocations; // only reported when counting allocations (see alloc::ENABLED)
+  std::optional<int64_t> solveAllocations;
+  std::optional<int64_t> allocatedBytes;
+  std::optional<int64_t> peakHeapBytes;
+
+  void write(std::ostream& out) const {
+    out << STRUCTURED_PREFIX << "part1 " << part1.value_or("") << "\n";
+    out << STRUCTURED_PREFIX << "part2 " << part2.value_or("") << "\n";
+    out << STRUCTURED_PREFIX << "parse_ns " << parseNs << "\n";
+    out << STRUCTURED_PREFIX << "solve_ns " << solveNs << "\n";
+    out << STRUCTURED_PREFIX << "peak_memory_kib " << peakMemoryKiB << "\n";
+    auto optional = [&](std::string_view key, const std::optional<int64_t>& value) {
+      if (value) {
+        out << STRUCTURED_PREFIX << key << " " << *value << "\n";
+      }
+    };
+    optional("parse_allocations", parseAllocations);
+    optional("solve_allocations", solveAllocations);
+    optional("allocated_bytes", allocatedBytes);
+    optional("peak_heap_bytes", peakHeapBytes);
+  }
+
+  static StructuredOutput parse(std::string_view output) {
+    StructuredOutput result;
+    while (!output.empty()) {
+      auto lineEnd = std::min(output.find('\n'), output.size());
+      auto line = output.substr(0, lineEnd);
+      output.remove_prefix(std::min(lineEnd + 1, output.size()));
+      if (line.ends_with('\r')) {
+        line.remove_suffix(1);
+      }
+      if (!line.starts_with(STRUCTURED_PREFIX)) {
+        continue;
+      }
+
+      line.remove_prefix(STRUCTURED_PREFIX.size());
+      auto separator = std::min(line.find(' '), line.size());
+      auto key = line.substr(0, separator);
+      auto value = line.substr(std::min(separator + 1, line.size()));
+      auto number = [&](int64_t& target) { std::from_chars(value.data(), value.data() + value.size(), target); };
+      auto optionalNumber = [&](std::optional<int64_t>& target) { number(target.emplace()); };
+
+      if (key == "part1") {
+        result.part1 = value;
+      } else if (key == "part2") {
+        result.part2 = value;
+      } else if (key == "parse_ns") {
+        number(result.parseNs);
+      } else if (key == "solve_ns") {
+        number(result.solveNs);
+      } else if (key == "peak_memory_kib") {
+        number(result.peakMemoryKiB);
+      } else if (key == "parse_allocations") {
+        optionalNumber(result.parseAllocations);
+      } else if (key == "solve_allocations") {
+        optionalNumber(result.solveAllocations);
+      } else if (key == "allocated_bytes") {
+        optionalNumber(result.allocatedBytes);
+      } else if (key == "peak_heap_bytes") {
+        optionalNumber(result.peakHeapBytes);
+      }
+    }
+    return result;
+  }
+};
+
+/** main() of the per-day executables: maps the task input (or the file given after INPUT_ARG) into memory, falling back
+ *  to task::inputString() if the input isn't found in the data directory, and prints the results
+ *  either for humans or, when started with STRUCTURED_OUTPUT_ARG, in the structured form read by check_all. The phase
+ *  timings of the structured output don't include reading the input file. With COUNTERS_ARG a table of performance
+ *  counters per phase follows, with PROFILE_ARG the report of all profile regions. THREADS_ARG limits the threads of
+ *  the parallel days.
+ */
+inline int runDay(SolveFn solve, int argc, char* argv[]) {
+  common::Time t;
+  bool structured = false;
+  bool counters = false;
+  bool profiled = false;
+  std::optional<std::string> inputPath;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == STRUCTURED_OUTPUT_ARG) {
+      structured = true;
+    } else if (arg == COUNTERS_ARG) {
+      counters = true;
+    } else if (arg == PROFILE_ARG) {
+      profiled = true;
+    } else if (arg == INPUT_ARG && i + 1 < argc) {
+      inputPath = argv[++i];
+    } else if (arg == THREADS_ARG && i + 1 < argc) {
+      threads::setThreadCount(static_cast<unsigned>(std::max(0, std::atoi(argv[++i]))));
+    } else {
+      std::cerr << "Unknown argument " << arg << "\n";
+      return 1;
+    }
+  }
+
+  // The solvers parse directly from the mapped file, so large inputs are neither copied nor read up front
+  input::MappedFile mapped(inputPath.value_or(defaultInputPath(solve)));
+  std::string copied;
+  if (!mapped.valid()) {
+    if (inputPath) {
+      std::cerr << "Cannot open " << *inputPath << "\n";
+      return 1;
+    }
+    copied = task::inputString();
+  }
+  std::string_view input = mapped.valid() ? mapped.view() : std::string_view(copied);
+  parseEnd.reset();
+  parseEndAllocations.reset();
+  alloc::resetPeak();
+  auto startAllocations = alloc::snapshot();
+  if (counters) {
+    perf::start();
+  }
+  if (profiled) {
+    profile::enable();
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::optional<Result> result;
+  try {
+    PROFILE_SCOPE("solve");
+    result.emplace(solve(input));
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << "\n"; // e.g. malformed input
+    return 1;
+  }
+  auto end = std::chrono::steady_clock::now();
+  perf::checkpoint("solve");
+  releaseArena();
+  auto endAllocations = alloc::snapshot();
+  auto parseAllocations = parseEndAllocations.value_or(startAllocations);
+
+  if (structured) {
+    auto solveStart = parseEnd.value_or(start);
+    StructuredOutput output{
+      .part1 = result->part1,
+      .part2 = result->part2,
+      .parseNs = std::chrono::duration_cast<std::chrono::nanoseconds>(solveStart - start).count(),
+      .solveNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - solveStart).count(),
+      .peakMemoryKiB = peakMemoryKiB(),
+      .parseAllocations = std::nullopt,
+      .solveAllocations = std::nullopt,
+      .allocatedBytes = std::nullopt,
+      .peakHeapBytes = std::nullopt
+    };
+    if (alloc::ENABLED) {
+      output.parseAllocations = parseAllocations.allocations - startAllocations.allocations;
+      output.solveAllocations = endAllocations.allocations - parseAllocations.allocations;
+      output.allocatedBytes = endAllocations.bytes - startAllocations.bytes;
+      output.peakHeapBytes = std::max(parseAllocations.peakLive, endAllocations.peakLive);
+    }
+    output.write(std::cout);
+  } else {
+    std::cout << "Part 1: " << result->part1 << "\n";
+    std::cout << "Part 2: " << result->part2 << "\n";
+    std::cout << t;
+    if (alloc::ENABLED) {
+      std::cout << "Allocations: " << parseAllocations.allocations - startAllocations.allocations << " parse, "
+        << endAllocations.allocations - parseAllocations.allocations << " solve, "
+        << (endAllocations.bytes - startAllocations.bytes) / 1024 << " KiB in total, peak heap "
+        << std::max(parseAllocations.peakLive, endAllocations.peakLive) / 1024 << " KiB, peak RSS " << peakMemoryKiB() << " KiB\n";
+    }
+  }
+
+  if (perf::activeRecorder) {
+    perf::activeRecorder->print(std::cout);
+  }
+  if (profiled) {
+    profile::report(std::cout);
+  }
+  return 0;
+}
+
+}
+
+#define REGISTER_SOLVER(day, solve) static registry::Registration solverRegistration(day, solve)
+
+/** Defining AOC_SOLVER_ONLY leaves out main() and the allocation hooks, so that all days can be linked into a single driver */
+#ifdef AOC_SOLVER_ONLY
+#define SOLVER_MAIN(solve)
+#else
+#define SOLVER_MAIN(solve) ALLOCATION_HOOKS() int main(int argc, char* argv[]) { return registry::runDay(solve, argc, argv); }
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <common/stream.hpp>
+
+#include <algorithm>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/** Expected results from data/results.txt, one line per day in the form `part1,part2` where each part may be quoted
+ *  (to contain commas) and the second part is optional. Lines starting with // are commented out days, which are skipped.
+ */
+namespace results {
+
+using Expected = std::optional<std::pair<std::string, std::optional<std::string>>>;
+
+/** Returns the first value of the given line and removes it from the line (without the quotes if quoted) */
+inline std::string_view takeValue(std::string_view& line, bool untilComma) {
+  if (line.starts_with('"')) {
+    auto closingQuote = line.find('"', 1);
+    if (closingQuote != std::string_view::npos) {
+      auto value = line.substr(1, closingQuote - 1);
+      line.remove_prefix(closingQuote + 1);
+      return value;
+    }
+  }
+
+  auto end = untilComma ? std::min(line.find(','), line.size()) : line.size();
+  auto value = line.substr(0, end);
+  line.remove_prefix(end);
+  return value;
+}
+
+inline Expected parseLine(std::string_view line) {
+  if (line.starts_with("//")) {
+    return std::nullopt; // commented out
+  }
+
+  std::pair<std::string, std::optional<std::string>> result;
+  result.first = takeValue(line, true);
+  if (line.starts_with(',')) {
+    line.remove_prefix(1);
+    result.second = takeValue(line, false);
+  }
+  return result;
+}
+
+inline std::vector<Expected> load(std::istream&& input) {
+  std::vector<Expected> results;
+  for (auto line : stream::lines(input)) {
+    results.push_back(parseLine(line));
+  }
+  return results;
+}
+
+}
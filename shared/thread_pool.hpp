@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/** Process wide thread pool with the parallel loops used by the days. The pool is started on first use with
+ *  threadCount() threads (including the thread, which waits for the work) and lives until the process exits, so the
+ *  solvers don't pay for starting threads on every run.
+ */
+namespace threads {
+
+inline std::atomic<unsigned> requestedThreads = 0;
+
+/** Sets the number of threads (0 = one per hardware thread, see registry::THREADS_ARG). Only has an effect before
+ *  the pool is used for the first time.
+ */
+inline void setThreadCount(unsigned count) {
+  requestedThreads = count;
+}
+
+inline unsigned threadCount() {
+  auto count = requestedThreads.load();
+  return count ? count : std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+class ThreadPool {
+public:
+  /** Starts threadCount - 1 workers, because the thread waiting for a task group also works on it */
+  explicit ThreadPool(unsigned threadCount) {
+    for (unsigned i = 1; i < threadCount; ++i) {
+      workers.emplace_back([this] { work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::unique_lock lock(mtx);
+      stopping = true;
+    }
+    wakeup.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** Number of threads working on tasks including the waiting thread */
+  unsigned size() const {
+    return static_cast<unsigned>(workers.size()) + 1;
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::unique_lock lock(mtx);
+      tasks.push_back(std::move(task));
+    }
+    wakeup.notify_one();
+  }
+
+  /** Runs the next queued task on the calling thread. Returns false if there was none */
+  bool runOne() {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mtx);
+      if (tasks.empty()) {
+        return false;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+    return true;
+  }
+
+private:
+  void work() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(mtx);
+        wakeup.wait(lock, [&] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) {
+          return; // stopping
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::mutex mtx;
+  std::condition_variable wakeup;
+  std::deque<std::function<void()>> tasks;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+};
+
+/** The shared pool, started on first use */
+inline ThreadPool& pool() {
+  static ThreadPool pool(threadCount());
+  return pool;
+}
+
+
+/** Tasks, which are waited for together. While waiting, the waiting thread runs queued tasks itself, so task groups
+ *  can be nested without running out of threads. The first exception thrown by a task is rethrown by wait().
+ */
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool& threadPool = pool()) : threadPool(threadPool) {}
+
+  ~TaskGroup() {
+    waitAll();
+  }
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  template<typename Task>
+  void run(Task&& task) {
+    {
+      std::unique_lock lock(mtx);
+      ++pending;
+    }
+    threadPool.submit([this, task = std::forward<Task>(task)]() mutable {
+      std::exception_ptr taskError;
+      try {
+        task();
+      } catch (...) {
+        taskError = std::current_exception();
+      }
+      // The group may be destroyed as soon as the waiting thread sees pending == 0, so nothing is touched after unlocking
+      std::unique_lock lock(mtx);
+      if (taskError && !error) {
+        error = taskError;
+      }
+      if (--pending == 0) {
+        done.notify_all();
+      }
+    });
+  }
+
+  void wait() {
+    waitAll();
+    if (error) {
+      std::rethrow_exception(std::exchange(error, nullptr));
+    }
+  }
+
+private:
+  void waitAll() {
+    for (;;) {
+      {
+        std::unique_lock lock(mtx);
+        if (pending == 0) {
+          return;
+        }
+      }
+      if (!threadPool.runOne()) {
+        // Nothing left to help with, the remaining tasks are already running
+        std::unique_lock lock(mtx);
+        done.wait(lock, [&] { return pending == 0; });
+        return;
+      }
+    }
+  }
+
+  ThreadPool& threadPool;
+  std::mutex mtx;
+  std::condition_variable done;
+  size_t pending = 0;
+  std::exception_ptr error;
+};
+
+
+/** Chunk size for n indices if none is given. It doesn't depend on the number of threads, so the chunks and thereby
+ *  the results of parallelReduce() are the same for every thread count.
+ */
+inline size_t defaultGrain(size_t n) {
+  constexpr size_t TARGET_CHUNKS = 256;
+  return std::max<size_t>(1, (n + TARGET_CHUNKS - 1) / TARGET_CHUNKS);
+}
+
+/** Splits [begin, end) into chunks of grain indices and calls chunkFn(chunkIndex, chunkBegin, chunkEnd) for each of them.
+ *
+ *  OPTIMIZATION: Each thread starts with its own contiguous block of chunks and only steals single chunks from the other
+ *                blocks once its block is done. Threads therefore work on separate, contiguous parts of the data (instead of
+ *                interleaving chunks and sharing cache lines or pages), while uneven chunks are still balanced at the end.
+ */
+template<typename ChunkFn>
+void forEachChunk(size_t begin, size_t end, size_t grain, ChunkFn&& chunkFn) {
+  if (begin >= end) {
+    return;
+  }
+  auto chunkCount = (end - begin + grain - 1) / grain;
+  auto runChunk = [&](size_t chunk) {
+    chunkFn(chunk, begin + chunk * grain, std::min(end, begin + (chunk + 1) * grain));
+  };
+
+  auto& threadPool = pool();
+  auto blockCount = std::min<size_t>(threadPool.size(), chunkCount);
+  if (blockCount <= 1) {
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+      runChunk(chunk);
+    }
+    return;
+  }
+
+  struct alignas(64) Block {
+    std::atomic<size_t> next;
+    size_t end;
+  };
+  std::vector<Block> blocks(blockCount);
+  for (size_t i = 0; i < blockCount; ++i) {
+    blocks[i].next = i * chunkCount / blockCount;
+    blocks[i].end = (i + 1) * chunkCount / blockCount;
+  }
+
+  auto work = [&](size_t self) {
+    for (size_t offset = 0; offset < blockCount; ++offset) {
+      auto& block = blocks[(self + offset) % blockCount];
+      for (size_t chunk; (chunk = block.next.fetch_add(1, std::memory_order_relaxed)) < block.end; ) {
+        runChunk(chunk);
+      }
+    }
+  };
+
+  TaskGroup group(threadPool);
+  for (size_t i = 1; i < blockCount; ++i) {
+    group.run([&work, i] { work(i); });
+  }
+  work(0);
+  group.wait();
+}
+
+/** Calls body(i) for every index in [begin, end) */
+template<typename Body>
+void parallelFor(size_t begin, size_t end, Body&& body, size_t grain = 0) {
+  forEachChunk(begin, end, grain ? grain : defaultGrain(end - begin), [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+    for (auto i = chunkBegin; i < chunkEnd; ++i) {
+      body(i);
+    }
+  });
+}
+
+/** Combines map(i) for all indices in [begin, end) starting from identity. Every chunk is reduced in index order
+ *  and the chunk results are combined in chunk order afterwards, so the result is deterministic regardless of the
+ *  number of threads and the scheduling, even if combine isn't associative (e.g. floating point sums).
+ */
+template<typename T, typename MapFn, typename CombineFn>
+T parallelReduce(size_t begin, size_t end, T identity, MapFn&& map, CombineFn&& combine, size_t grain = 0) {
+  if (begin >= end) {
+    return identity;
+  }
+  grain = grain ? grain : defaultGrain(end - begin);
+  std::vector<T> partials((end - begin + grain - 1) / grain, identity);
+  forEachChunk(begin, end, grain, [&](size_t chunk, size_t chunkBegin, size_t chunkEnd) {
+    T partial = identity;
+    for (auto i = chunkBegin; i < chunkEnd; ++i) {
+      partial = combine(std::move(partial), map(i));
+    }
+    partials[chunk] = std::move(partial);
+  });
+
+  T result = std::move(identity);
+  for (auto& partial : partials) {
+    result = combine(std::move(result), std::move(partial));
+  }
+  return result;
+}
+
+/** Sorts [first, last) by sorting chunks of grain elements in parallel and merging them pairwise in parallel rounds.
+ *  As for parallelReduce() the chunks don't depend on the number of threads, so elements which compare equal end up
+ *  in the same order for every thread count.
+ */
+template<std::random_access_iterator It, typename Compare = std::less<>>
+void parallelSort(It first, It last, Compare compare = {}, size_t grain = 0) {
+  auto n = static_cast<size_t>(last - first);
+  // Few large chunks, because the last merge rounds have little parallelism left
+  grain = grain ? grain : std::max<size_t>(4096, (n + 15) / 16);
+  forEachChunk(0, n, grain, [&](size_t, size_t chunkBegin, size_t chunkEnd) {
+    std::sort(first + chunkBegin, first + chunkEnd, compare);
+  });
+
+  for (size_t width = grain; width < n; width *= 2) {
+    parallelFor(0, (n + 2 * width - 1) / (2 * width), [&](size_t pair) {
+      auto begin = pair * 2 * width;
+      auto middle = std::min(n, begin + width);
+      auto end = std::min(n, begin + 2 * width);
+      std::inplace_merge(first + begin, first + middle, first + end, compare);
+    }, 1);
+  }
+}
+
+
+}